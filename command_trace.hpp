@@ -0,0 +1,46 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+// format of the command trace file, shared with the reader in tests/.
+namespace command_trace
+{
+	// the trace file consists of a file_header, the command names
+	// (null-terminated UTF-16, edit menu items followed by object menu items,
+	// names_size bytes in total), and then records in the invoked order.
+	// all values are in little endian.
+	constexpr uint32_t magic = 0x52545754; // "TWTR".
+	constexpr uint32_t version = 1;
+
+	struct file_header {
+		uint32_t magic, version;
+		int64_t counter_frequency;
+		uint32_t edit_count, obj_count, names_size, reserved;
+	};
+	static_assert(sizeof(file_header) == 32);
+	struct record {
+		int64_t start; // performance counter when invoked.
+		uint32_t duration; // in performance counter ticks.
+		uint16_t command; // index into the names.
+		uint16_t selected_count;
+
+		// the state of EDIT_INFO when invoked.
+		int32_t scene_id, frame, layer, frame_max, layer_max,
+			display_frame_start, display_layer_start;
+		int32_t reserved;
+	};
+	static_assert(sizeof(record) == 48);
+}
@@ -0,0 +1,374 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <span>
+#include <vector>
+#include <unordered_map>
+
+// undo histories of the cursor and their polling, without any OS dependency.
+// the clock is given as a policy `ClockT` whose `ClockT::now()` returns the time in milliseconds.
+
+template<class T>
+struct undo_history {
+	size_t size() const { return n; }
+	size_t max_size() const { return N; }
+	size_t memory_size() const { return vals.capacity() * sizeof(T); }
+	void forward(T v)
+	{
+		n++;
+		if (n > N) {
+			i0 = (i0 + n) % N;
+			n = N;
+		}
+		size_t i = (i0 + n - 1) % N;
+		if (i < vals.size()) vals[i] = v;
+		else {
+			// the buffer grows lazily until it wraps around.
+			if (vals.size() == vals.capacity())
+				vals.reserve(std::min(N, std::max<size_t>(16, 2 * vals.capacity())));
+			vals.push_back(v);
+		}
+		m = n;
+	}
+	bool check_forward(T v)
+	{
+		if (v == peek()) return false;
+		forward(v);
+		return true;
+	}
+	bool repush(T& v)
+	{
+		if (m <= n) return false;
+		n++;
+		size_t i = (i0 + n - 1) % N;
+		v = vals[i];
+		return true;
+	}
+	T peek() const
+	{
+		if (n == 0) return T{};
+		size_t i = (i0 + n - 1) % N;
+		return vals[i];
+	}
+	T backward()
+	{
+		if (n == 0) return T{};
+		else if (n > 1) n--;
+		size_t i = (i0 + n - 1) % N;
+		return vals[i];
+	}
+	void clear(T v)
+	{
+		i0 = n = m = 0;
+		vals.clear();
+		forward(v);
+	}
+	// the entries from the oldest, including the ones for redo.
+	// `position()` of them are for undo.
+	std::vector<T> entries() const
+	{
+		std::vector<T> ret{}; ret.reserve(m);
+		for (size_t k = 0; k < m; k++) ret.push_back(vals[(i0 + k) % N]);
+		return ret;
+	}
+	size_t position() const { return n; }
+	void assign(std::span<T const> entries, size_t pos)
+	{
+		// keep the newest ones if there are too many.
+		if (entries.size() > N) {
+			size_t const drop = entries.size() - N;
+			entries = entries.subspan(drop);
+			pos = pos > drop ? pos - drop : 1;
+		}
+		i0 = 0; m = entries.size();
+		n = std::min(std::max<size_t>(pos, 1), m);
+		vals.assign(entries.begin(), entries.end());
+	}
+	constexpr undo_history(size_t N) : N{ N }, i0{ 0 }, n{ 0 }, m{ 0 } {}
+private:
+	size_t i0, n, m, N;
+	std::vector<T> vals{};
+};
+template<class KeyT, class ValT>
+struct undo_bundle {
+private:
+	struct entry {
+		undo_history<ValT> history;
+		uint64_t last_used;
+	};
+	size_t max_len;
+	size_t budget; // in bytes, for all the histories.
+	size_t extra = 0; // in bytes, used along with the histories, such as bookmarks.
+	uint64_t use_count = 0;
+	std::unordered_map<KeyT, entry> queues{};
+	undo_history<ValT>* curr = nullptr;
+
+	void evict()
+	{
+		// discard least recently used histories until the total fits in the budget.
+		size_t total = extra;
+		for (auto const& [_, e] : queues) total += e.history.memory_size();
+		while (total > budget && queues.size() > 1) {
+			auto lru = std::min_element(queues.begin(), queues.end(),
+				[](auto const& l, auto const& r) { return l.second.last_used < r.second.last_used; });
+			if (&lru->second.history == curr) break; // never happens as curr is the most recent.
+			total -= lru->second.history.memory_size();
+			queues.erase(lru);
+		}
+	}
+
+public:
+	void set_key(KeyT const& key, ValT const& init)
+	{
+		auto p = queues.try_emplace(key, undo_history<ValT>{ max_len }, 0);
+		if (p.second) p.first->second.history.clear(init);
+		p.first->second.last_used = ++use_count;
+		curr = &p.first->second.history;
+		evict();
+	}
+	void clear()
+	{
+		queues.clear();
+		curr = nullptr;
+	}
+	undo_history<ValT>* current() const { return curr; }
+
+	// records to the current history, and discards others if its buffer has grown.
+	bool check_forward(ValT const& v)
+	{
+		if (curr == nullptr) return false;
+		size_t const size = curr->memory_size();
+		bool const ret = curr->check_forward(v);
+		if (curr->memory_size() != size) evict();
+		return ret;
+	}
+	void set_extra_memory(size_t size)
+	{
+		extra = size;
+		evict();
+	}
+
+	// access to all the histories, for persistence.
+	template<class F>
+	void for_each(F&& f) const
+	{
+		for (auto const& [key, e] : queues) f(key, e.history);
+	}
+	bool contains(KeyT const& key) const { return queues.contains(key); }
+	undo_history<ValT>& restore(KeyT const& key)
+	{
+		auto& e = queues.try_emplace(key, undo_history<ValT>{ max_len }, 0).first->second;
+		e.last_used = ++use_count;
+		return e.history;
+	}
+	undo_bundle(size_t max_len, size_t budget) : max_len{ max_len }, budget{ budget }, queues{} {}
+};
+
+template<class KeyT, class ValT, class ClockT>
+struct cooltime_undo_bundle : undo_bundle<KeyT, ValT> {
+private:
+	uint64_t last_poll_time = 0;
+
+public:
+	double polling_cooltime; // in seconds.
+
+	bool is_cooltime(uint64_t curr_time) const
+	{
+		if (last_poll_time > 0 && (curr_time - last_poll_time) * 0.001 < polling_cooltime)
+			return true;
+		return false;
+	}
+	void set_cooltime(uint64_t curr_time)
+	{
+		last_poll_time = curr_time;
+	}
+	static uint64_t get_curr_polltime()
+	{
+		return ClockT::now();
+	}
+
+	bool check_cooltime(uint64_t curr_time)
+	{
+		if (is_cooltime(curr_time)) return true;
+		set_cooltime(curr_time);
+		return false;
+	}
+	bool check_cooltime()
+	{
+		return check_cooltime(get_curr_polltime());
+	}
+	void reset_cooltime()
+	{
+		set_cooltime(0);
+	}
+
+	cooltime_undo_bundle(size_t max_len, size_t budget, double polling_cooltime = 0.5)
+		: undo_bundle<KeyT, ValT>{ max_len, budget }, polling_cooltime{ polling_cooltime } {};
+};
+
+// an entry of the cursor history: the cursor position and the origin of the timeline view.
+// packed into 8 bytes with the view relative to the cursor, as the budget of the histories
+// counts their bytes. positions out of range are clamped, and a view too far from the cursor
+// is scrolled to show the cursor when restored.
+struct cursor_state {
+	int32_t frame : 24;
+	int32_t view_layer_offset : 8; // from `layer`.
+	int32_t layer : 12;
+	int32_t view_frame_offset : 20; // from `frame`.
+
+	constexpr static int clamp_bits(int v, int bits, int min)
+	{
+		return std::clamp(v, min, (1 << (bits - 1)) - 1);
+	}
+
+	constexpr int view_layer() const { return layer + view_layer_offset; }
+	constexpr int view_frame() const { return frame + view_frame_offset; }
+
+	// only the cursor position is compared, so scrolling alone doesn't make a new entry.
+	constexpr bool operator==(cursor_state const& r) const { return frame == r.frame && layer == r.layer; }
+
+	static constexpr cursor_state make(int layer, int frame, int view_layer, int view_frame)
+	{
+		layer = clamp_bits(layer, 12, 0);
+		frame = clamp_bits(frame, 24, 0);
+		return {
+			.frame = frame,
+			.view_layer_offset = clamp_bits(view_layer - layer, 8, -(1 << 7)),
+			.layer = layer,
+			.view_frame_offset = clamp_bits(view_frame - frame, 20, -(1 << 19)),
+		};
+	}
+	// `InfoT` is EDIT_INFO.
+	template<class InfoT>
+	static constexpr cursor_state from(InfoT const& info, int layer, int frame)
+	{
+		return make(layer, frame, info.display_layer_start, info.display_frame_start);
+	}
+	template<class InfoT>
+	static constexpr cursor_state from(InfoT const& info) { return from(info, info.layer, info.frame); }
+};
+static_assert(sizeof(cursor_state) == 8);
+
+// detection of continuous frame changes, such as playback or scrubbing.
+// the host doesn't tell its playback state, so it's guessed from a run of
+// quick forward steps by the same amount.
+struct playback_detector {
+	constexpr static uint64_t interval = 125; // in milliseconds. covers playback down to 8 fps.
+	constexpr static int run_length = 4; // steps required to be considered playback.
+
+private:
+	uint64_t last_event_time = 0;
+	int last_frame = 0, last_delta = 0;
+	int run = 0; // number of consecutive steps that look like playback.
+
+public:
+	// feeds a change of the frame at `time` in milliseconds.
+	// returns true if it looks like playback.
+	bool step(uint64_t time, int frame)
+	{
+		int const delta = frame - last_frame;
+		bool const rapid = last_event_time > 0 && time - last_event_time < interval
+			&& delta > 0 && delta == last_delta;
+		last_event_time = time;
+		last_frame = frame;
+		last_delta = delta;
+		run = rapid ? run + 1 : 0;
+		return run >= run_length;
+	}
+	void reset()
+	{
+		last_event_time = 0;
+		run = 0;
+	}
+};
+
+// records the cursor to the history on every change of the frame.
+// continuous frame changes, such as playback or scrubbing, suspend the polling entirely,
+// and a single entry is recorded when they settle.
+// `ValT` has the member `frame`.
+template<class KeyT, class ValT, class ClockT>
+struct cursor_poller {
+	using bundle_type = cooltime_undo_bundle<KeyT, ValT, ClockT>;
+
+	enum class result {
+		recorded,
+		unchanged, // the same position as the last entry.
+		cooltime, // skipped by the polling cooltime.
+		playback_begun, // the caller starts calling `check_settled()` periodically.
+		playback, // skipped during playback.
+	};
+
+private:
+	bundle_type& bundle;
+	playback_detector detector{};
+	bool active = false;
+	bool dirty = false; // frame changed since the last settle check.
+
+public:
+	bool playing() const { return active; }
+
+	// `get_state()` is called only when the state is needed.
+	template<class F>
+	result on_frame_changed(F&& get_state)
+	{
+		if (active) {
+			// wait until the playback settles.
+			dirty = true;
+			return result::playback;
+		}
+
+		auto const t = bundle.get_curr_polltime();
+		ValT const v = get_state();
+		if (detector.step(t, v.frame)) {
+			active = true;
+			dirty = false;
+			return result::playback_begun;
+		}
+
+		// suppress polling for a certain amount of time.
+		if (bundle.check_cooltime(t)) return result::cooltime;
+
+		// update the history.
+		return bundle.check_forward(v) ? result::recorded : result::unchanged;
+	}
+
+	// called periodically during playback.
+	// returns true if it has settled, recording the position.
+	template<class F>
+	bool check_settled(F&& get_state)
+	{
+		if (std::exchange(dirty, false)) return false; // still moving.
+
+		end();
+		if (bundle.current() != nullptr) {
+			bundle.check_forward(get_state());
+			bundle.set_cooltime(bundle.get_curr_polltime());
+		}
+		return true;
+	}
+
+	// returns false if it wasn't in playback.
+	bool end()
+	{
+		if (!active) return false;
+		active = false;
+		detector.reset();
+		return true;
+	}
+
+	explicit cursor_poller(bundle_type& bundle) : bundle{ bundle } {}
+};
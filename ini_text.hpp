@@ -0,0 +1,131 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cwchar>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <ranges>
+
+// contents of an .ini file as text, without any file access or OS dependency.
+// comments and unknown keys are kept as they are.
+class ini_text {
+	struct entry {
+		std::wstring section, key, value;
+		size_t line;
+	};
+	std::vector<std::wstring> lines{};
+	std::vector<entry> entries{};
+	std::vector<std::pair<std::wstring, size_t>> headers{}; // section name and its line.
+
+	static std::wstring_view trim(std::wstring_view const& str)
+	{
+		constexpr std::wstring_view spaces = L" \t\r";
+		auto const pos = str.find_first_not_of(spaces);
+		if (pos == str.npos) return {};
+		return str.substr(pos, str.find_last_not_of(spaces) + 1 - pos);
+	}
+	// sections and keys are compared case-insensitively in ASCII.
+	static bool equal_ci(std::wstring_view const& a, std::wstring_view const& b)
+	{
+		constexpr auto fold = [](wchar_t c) { return L'A' <= c && c <= L'Z' ? static_cast<wchar_t>(c - L'A' + L'a') : c; };
+		return std::ranges::equal(a, b, {}, fold, fold);
+	}
+	entry* find(std::wstring_view const& section, std::wstring_view const& key)
+	{
+		for (auto& e : entries) {
+			if (equal_ci(e.key, key) && equal_ci(e.section, section)) return &e;
+		}
+		return nullptr;
+	}
+	void insert_line(size_t pos, std::wstring&& line)
+	{
+		lines.insert(lines.begin() + pos, std::move(line));
+		for (auto& e : entries) if (e.line >= pos) e.line++;
+		for (auto& h : headers) if (h.second >= pos) h.second++;
+	}
+
+public:
+	void parse(std::wstring_view const& text)
+	{
+		lines.clear(); entries.clear(); headers.clear();
+		std::wstring section{};
+		for (auto const part : text | std::views::split(L'\n')) {
+			std::wstring_view const line{ part.begin(), part.end() };
+			auto const t = trim(line);
+			if (t.starts_with(L'[')) {
+				section = trim(t.substr(1, t.find(L']') - 1));
+				headers.emplace_back(section, lines.size());
+			}
+			else if (auto const eq = t.find(L'='); !t.starts_with(L';') && eq != t.npos)
+				entries.push_back({ section, std::wstring{ trim(t.substr(0, eq)) }, std::wstring{ trim(t.substr(eq + 1)) }, lines.size() });
+			lines.emplace_back(line.ends_with(L'\r') ? line.substr(0, line.size() - 1) : line);
+		}
+		if (!lines.empty() && lines.back().empty()) lines.pop_back(); // the trailing newline.
+	}
+
+	// the whole text with CRLF line endings.
+	std::wstring text() const
+	{
+		std::wstring ret{};
+		for (auto const& line : lines) (ret += line) += L"\r\n";
+		return ret;
+	}
+
+	std::optional<std::wstring_view> get(std::wstring_view const& section, std::wstring_view const& key)
+	{
+		if (auto const e = find(section, key); e != nullptr) return e->value;
+		return std::nullopt;
+	}
+	int get_int(std::wstring_view const& section, std::wstring_view const& key, int default_value)
+	{
+		auto const raw = get(section, key);
+		if (!raw || raw->empty()) return default_value;
+		std::wstring const str{ *raw }; wchar_t* e;
+		auto const v = std::wcstol(str.c_str(), &e, 10);
+		return e != str.c_str() ? static_cast<int>(v) : default_value;
+	}
+	// enumerates the keys in the order of the text, as f(section, key, value).
+	template<class F>
+	void for_each(F&& f) const
+	{
+		for (auto const& e : entries) f(std::wstring_view{ e.section }, std::wstring_view{ e.key }, std::wstring_view{ e.value });
+	}
+	void set(std::wstring_view const& section, std::wstring_view const& key, std::wstring_view const& value)
+	{
+		if (auto const e = find(section, key); e != nullptr) {
+			e->value = value;
+			lines[e->line] = e->key + L'=' + e->value;
+			return;
+		}
+
+		// append to the end of the section, or a new section.
+		size_t pos;
+		if (auto const h = std::ranges::find_if(headers, [&](auto const& h) { return equal_ci(h.first, section); });
+			h != headers.end()) pos = h->second;
+		else {
+			pos = lines.size();
+			headers.emplace_back(section, pos);
+			lines.emplace_back(L'[' + std::wstring{ section } + L']');
+		}
+		for (auto const& e : entries)
+			if (equal_ci(e.section, section)) pos = std::max(pos, e.line);
+		insert_line(++pos, std::wstring{ key } + L'=' + std::wstring{ value });
+		entries.push_back({ std::wstring{ section }, std::wstring{ key }, std::wstring{ value }, pos });
+	}
+};
@@ -20,3 +20,55 @@ extern "C" __declspec(dllexport) void InitializeLogger(LOG_HANDLE* handle)
 {
 	AviUtl2::logging::logger = handle;
 }
+
+
+////////////////////////////////
+// message buffering.
+////////////////////////////////
+namespace
+{
+	using namespace AviUtl2::logging;
+
+	constinit struct {
+		struct {
+			level lv;
+			wchar_t text[buffer::slot_len];
+		} slots[buffer::slot_count]{};
+		size_t head = 0, count = 0;
+	} ring{};
+}
+
+wchar_t* AviUtl2::logging::buffer::acquire()
+{
+	// make room by forwarding the pending messages if full.
+	if (ring.count >= slot_count) flush();
+	return ring.slots[(ring.head + ring.count) % slot_count].text;
+}
+
+void AviUtl2::logging::buffer::commit(level lv)
+{
+	ring.slots[(ring.head + ring.count) % slot_count].lv = lv;
+	ring.count++;
+
+	// errors are shown without delay.
+	if (request_flush == nullptr || lv >= level::error) flush();
+	else if (ring.count == 1) request_flush();
+}
+
+void AviUtl2::logging::flush()
+{
+	if (logger == nullptr) {
+		ring.count = 0;
+		return;
+	}
+	for (; ring.count > 0; ring.count--, ring.head = (ring.head + 1) % buffer::slot_count) {
+		auto const& slot = ring.slots[ring.head];
+		switch (slot.lv) {
+		case level::verbose:	logger->verbose(logger, slot.text); break;
+		case level::log:		logger->log(logger, slot.text); break;
+		case level::info:		logger->info(logger, slot.text); break;
+		case level::warn:		logger->warn(logger, slot.text); break;
+		case level::error:		logger->error(logger, slot.text); break;
+		}
+	}
+}
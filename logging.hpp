@@ -12,17 +12,78 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 
 #pragma once
 
+#include <cstdint>
+#include <cerrno>
+#include <cwchar>
 using LPCWSTR = wchar_t const*;
 #include <logger2.h>
 
+// messages below this level are stripped at compile time.
+// 0: verbose, 1: log, 2: info, 3: warn, 4: error.
+#ifndef LOGGING_MIN_LEVEL
+#define LOGGING_MIN_LEVEL 0
+#endif
+
 namespace AviUtl2::logging
 {
+	enum class level : uint8_t { verbose, log, info, warn, error };
+	constexpr level min_level = static_cast<level>(LOGGING_MIN_LEVEL);
+
 	inline LOG_HANDLE* logger = nullptr;
-	inline void log(wchar_t const* mes) { logger->log(logger, mes); }
-	inline void info(wchar_t const* mes) { logger->info(logger, mes); }
-	inline void warn(wchar_t const* mes) { logger->warn(logger, mes); }
-	inline void error(wchar_t const* mes) { logger->error(logger, mes); }
-	inline void verbose(wchar_t const* mes) { logger->verbose(logger, mes); }
+
+	// messages are formatted into a preallocated ring buffer, and forwarded
+	// to the logger in batches by flush(). not thread-safe; use from the UI thread only.
+	namespace buffer
+	{
+		constexpr size_t slot_count = 64, slot_len = 256;
+
+		// called when the buffer gets non-empty, to schedule flush().
+		// if not set, messages are forwarded immediately.
+		inline void (*request_flush)() = nullptr;
+
+		wchar_t* acquire();
+		void commit(level lv);
+
+		// marks a message cut at the end of the slot.
+		inline void mark_truncated(wchar_t* slot)
+		{
+			size_t pos = slot_len - 2;
+			if ((slot[pos - 1] & 0xfc00) == 0xd800) pos--; // don't split a surrogate pair.
+			slot[pos] = L'\u2026'; // horizontal ellipsis.
+			slot[pos + 1] = L'\0';
+		}
+	}
+	void flush();
+
+	template<level lv>
+	inline void write(wchar_t const* mes)
+	{
+		if constexpr (lv >= min_level) {
+			if (logger == nullptr) return;
+			auto const slot = buffer::acquire();
+			if (::wcsncpy_s(slot, buffer::slot_len, mes, _TRUNCATE) == STRUNCATE)
+				buffer::mark_truncated(slot);
+			buffer::commit(lv);
+		}
+	}
+	template<level lv, class... ArgsT>
+	inline void write(wchar_t const* fmt, ArgsT const&... args)
+	{
+		if constexpr (lv >= min_level) {
+			if (logger == nullptr) return;
+			// formatted here, as the arguments may not outlive this call.
+			auto const slot = buffer::acquire();
+			if (::_snwprintf_s(slot, buffer::slot_len, _TRUNCATE, fmt, args...) < 0)
+				buffer::mark_truncated(slot);
+			buffer::commit(lv);
+		}
+	}
+
+	inline void log(wchar_t const* mes, auto const&... args) { write<level::log>(mes, args...); }
+	inline void info(wchar_t const* mes, auto const&... args) { write<level::info>(mes, args...); }
+	inline void warn(wchar_t const* mes, auto const&... args) { write<level::warn>(mes, args...); }
+	inline void error(wchar_t const* mes, auto const&... args) { write<level::error>(mes, args...); }
+	inline void verbose(wchar_t const* mes, auto const&... args) { write<level::verbose>(mes, args...); }
 }
 
 #if _DEBUG
@@ -0,0 +1,174 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cwchar>
+#include <algorithm>
+#include <utility>
+#include <optional>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <iterator>
+
+#include "ini_text.hpp"
+#include "timeline_model.hpp"
+
+// reads AviUtl2 project files (.aup2) into timeline_model, without the host.
+// the file is a UTF-8 text in the .ini syntax:
+//   [scene.<id>]    name, video.rate, video.scale, cursor.frame, cursor.layer,
+//                   layer.<layer>.enable, layer.<layer>.lock,
+//                   mark.<n>=<frame>[,<memo>],
+//                   grid.bpm.<n>=<tempo>,<beat>,<offset>,<start>
+//   [<object>]      layer, frame=<start>[,<section start>...],<end>
+//                   belongs to the last [scene.<id>] before it.
+//   [<object>.<n>]  effects of the object, ignored.
+// other sections and keys are ignored.
+namespace aup2
+{
+	inline std::wstring from_utf8(std::string_view src)
+	{
+		if (src.starts_with("\xef\xbb\xbf")) src.remove_prefix(3);
+		std::wstring ret{}; ret.reserve(src.size());
+		for (size_t i = 0; i < src.size(); ) {
+			auto const c = static_cast<uint8_t>(src[i]);
+			int const len = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+			uint32_t cp = len == 1 ? c : c & (0x7f >> len);
+			for (int k = 1; k < len && i + k < src.size(); k++)
+				cp = (cp << 6) | (static_cast<uint8_t>(src[i + k]) & 0x3f);
+			i += len;
+			if constexpr (sizeof(wchar_t) == 2) {
+				if (cp >= 0x10000) {
+					cp -= 0x10000;
+					ret += static_cast<wchar_t>(0xd800 + (cp >> 10));
+					cp = 0xdc00 + (cp & 0x3ff);
+				}
+			}
+			ret += static_cast<wchar_t>(cp);
+		}
+		return ret;
+	}
+
+	// splits comma-separated values.
+	inline std::vector<std::wstring_view> split(std::wstring_view str)
+	{
+		std::vector<std::wstring_view> ret{};
+		for (size_t pos; (pos = str.find(L',')) != str.npos; str.remove_prefix(pos + 1))
+			ret.push_back(str.substr(0, pos));
+		ret.push_back(str);
+		return ret;
+	}
+	inline std::optional<int> to_int(std::wstring_view str)
+	{
+		std::wstring const s{ str }; wchar_t* e;
+		auto const v = std::wcstol(s.c_str(), &e, 10);
+		if (e == s.c_str()) return std::nullopt;
+		return static_cast<int>(v);
+	}
+	inline std::optional<double> to_double(std::wstring_view str)
+	{
+		std::wstring const s{ str }; wchar_t* e;
+		auto const v = std::wcstod(s.c_str(), &e);
+		if (e == s.c_str()) return std::nullopt;
+		return v;
+	}
+	// "<prefix><number><rest>" to the number and the rest.
+	inline std::optional<std::pair<int, std::wstring_view>> numbered(std::wstring_view str, std::wstring_view prefix)
+	{
+		if (!str.starts_with(prefix)) return std::nullopt;
+		str.remove_prefix(prefix.size());
+		size_t const len = std::ranges::find_if(str, [](wchar_t c) { return c < L'0' || c > L'9'; }) - str.begin();
+		if (len == 0) return std::nullopt;
+		return std::pair{ *to_int(str.substr(0, len)), str.substr(len) };
+	}
+
+	// returns nullopt if there is no scene.
+	inline std::optional<timeline_model> parse(std::wstring_view const& text)
+	{
+		ini_text ini{};
+		ini.parse(text);
+
+		timeline_model ret{};
+		timeline_model::scene* scene = nullptr;
+		timeline_model::object* obj = nullptr;
+		std::wstring last_section{};
+		ini.for_each([&](std::wstring_view section, std::wstring_view key, std::wstring_view value)
+		{
+			if (section != last_section) {
+				last_section = section;
+				obj = nullptr;
+				if (auto const id = numbered(section, L"scene."); id && id->second.empty()) {
+					scene = ret.find_scene(id->first);
+					if (scene == nullptr) scene = &ret.scenes.emplace_back(timeline_model::scene{ .id = id->first });
+				}
+				else if (auto const n = numbered(section, L""); n && n->second.empty() && scene != nullptr)
+					obj = &scene->objects.emplace_back(timeline_model::object{ .layer = 0, .start = 0, .end = 0 });
+			}
+
+			if (obj != nullptr) {
+				if (key == L"layer") obj->layer = to_int(value).value_or(0);
+				else if (key == L"frame") {
+					auto const vals = split(value);
+					obj->start = to_int(vals.front()).value_or(0);
+					obj->end = to_int(vals.back()).value_or(obj->start);
+					obj->sections.clear();
+					for (size_t i = 1; i + 1 < vals.size(); i++)
+						if (auto const f = to_int(vals[i])) obj->sections.push_back(*f);
+				}
+			}
+			else if (scene != nullptr && section.starts_with(L"scene.")) {
+				if (key == L"name") scene->name = value;
+				else if (key == L"video.rate") scene->rate = to_int(value).value_or(scene->rate);
+				else if (key == L"video.scale") scene->scale = to_int(value).value_or(scene->scale);
+				else if (key == L"cursor.frame") scene->frame = to_int(value).value_or(0);
+				else if (key == L"cursor.layer") scene->layer = to_int(value).value_or(0);
+				else if (auto const l = numbered(key, L"layer."); l && (l->second == L".enable" || l->second == L".lock")) {
+					auto& state = scene->layers[l->first];
+					(l->second == L".enable" ? state.enable : state.lock) = to_int(value).value_or(0) != 0;
+				}
+				else if (auto const m = numbered(key, L"mark."); m && m->second.empty()) {
+					auto const comma = value.find(L',');
+					if (auto const f = to_int(value.substr(0, comma)))
+						scene->marks.push_back({ *f, std::wstring{ comma != value.npos ? value.substr(comma + 1) : L"" } });
+				}
+				else if (auto const b = numbered(key, L"grid.bpm."); b && b->second.empty()) {
+					auto const vals = split(value);
+					if (vals.size() >= 4) {
+						scene->bpm.push_back({
+							.tempo = static_cast<float>(to_double(vals[0]).value_or(120)),
+							.beat = to_int(vals[1]).value_or(4),
+							.offset = static_cast<float>(to_double(vals[2]).value_or(0)),
+							.start = to_double(vals[3]).value_or(0),
+						});
+					}
+				}
+			}
+		});
+		if (ret.scenes.empty()) return std::nullopt;
+
+		for (auto& s : ret.scenes) s.normalize();
+		return ret;
+	}
+
+	// returns nullopt if the file couldn't be read or has no scene.
+	inline std::optional<timeline_model> load(char const* path)
+	{
+		std::ifstream in{ path, std::ios::binary };
+		if (!in) return std::nullopt;
+		std::string const bytes{ std::istreambuf_iterator<char>{ in }, {} };
+		return parse(from_utf8(bytes));
+	}
+}
@@ -0,0 +1,159 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+// loads .aup2 projects into timeline_model.
+//   aup2_loader_test [project.aup2...]
+// with arguments, the given projects are loaded and summarized instead.
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "aup2_loader.hpp"
+
+static int failures = 0;
+#define EXPECT(cond) ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond), failures++))
+
+static constexpr std::string_view sample =
+	"\xef\xbb\xbf[project]\r\n"
+	"version=2001500\r\n"
+	"[scene.0]\r\n"
+	"scene=0\r\n"
+	"name=Root\r\n"
+	"video.rate=30000\r\n"
+	"video.scale=1001\r\n"
+	"cursor.frame=45\r\n"
+	"cursor.layer=2\r\n"
+	"layer.1.enable=0\r\n"
+	"layer.3.lock=1\r\n"
+	"mark.0=90,\xe3\x82\xb5\xe3\x83\x93, chorus\r\n" // "サビ, chorus"
+	"mark.1=15\r\n"
+	"grid.bpm.0=128,4,0.25,0\r\n"
+	"grid.bpm.1=96.5,3,0,12.5\r\n"
+	"[0]\r\n"
+	"layer=2\r\n"
+	"focus=1\r\n"
+	"frame=60,119\r\n"
+	"[0.0]\r\n"
+	"effect.name=\xe5\x9b\xb3\xe5\xbd\xa2\r\n" // "図形"
+	"frame=999\r\n"
+	"[1]\r\n"
+	"layer=2\r\n"
+	"frame=0,20,40,59\r\n"
+	"[1.0]\r\n"
+	"effect.name=text\r\n"
+	"[scene.1]\r\n"
+	"name=Sub\r\n"
+	"[2]\r\n"
+	"layer=0\r\n"
+	"frame=10,10\r\n";
+
+static void test_sample()
+{
+	auto const model = aup2::parse(aup2::from_utf8(sample));
+	EXPECT(model.has_value());
+	if (!model) return;
+	EXPECT(model->scenes.size() == 2);
+
+	auto const& root = model->scenes[0];
+	EXPECT(root.id == 0 && root.name == L"Root");
+	EXPECT(root.rate == 30000 && root.scale == 1001);
+	EXPECT(root.frame == 45 && root.layer == 2);
+
+	// objects are sorted, with the frames of mid-points. effects don't override them.
+	EXPECT(root.objects.size() == 2);
+	EXPECT(root.objects[0].layer == 2 && root.objects[0].start == 0 && root.objects[0].end == 59);
+	EXPECT((root.objects[0].sections == std::vector<int>{ 20, 40 }));
+	EXPECT(root.objects[0].section_num() == 3);
+	EXPECT(root.objects[1].start == 60 && root.objects[1].end == 119 && root.objects[1].sections.empty());
+	EXPECT(root.frame_max() == 119 && root.layer_max() == 3);
+
+	EXPECT(!root.layer_at(1).enable && !root.layer_at(1).lock);
+	EXPECT(root.layer_at(3).enable && root.layer_at(3).lock);
+	EXPECT(root.layer_at(2).enable && !root.layer_at(2).lock);
+
+	// marks are sorted, and memos may have commas.
+	EXPECT(root.marks.size() == 2);
+	EXPECT(root.marks[0].frame == 15 && root.marks[0].memo.empty());
+	EXPECT(root.marks[1].frame == 90 && root.marks[1].memo == L"\u30b5\u30d3, chorus");
+
+	EXPECT(root.bpm.size() == 2);
+	EXPECT(root.bpm[0].tempo == 128 && root.bpm[0].beat == 4 && root.bpm[0].offset == 0.25f);
+	EXPECT(root.bpm[1].tempo == 96.5f && root.bpm[1].beat == 3 && root.bpm[1].start == 12.5);
+
+	// objects belong to the scene before them.
+	auto const& sub = model->scenes[1];
+	EXPECT(sub.id == 1 && sub.name == L"Sub");
+	EXPECT(sub.objects.size() == 1 && sub.objects[0].start == 10 && sub.objects[0].end == 10);
+	EXPECT(sub.rate == 60 && sub.scale == 1);
+}
+
+static void test_invalid()
+{
+	EXPECT(!aup2::parse(L""));
+	EXPECT(!aup2::parse(L"[project]\nversion=1\n[0]\nlayer=1\nframe=0,9\n")); // no scene.
+
+	// broken values fall back to defaults.
+	auto const model = aup2::parse(L"[scene.0]\nvideo.rate=x\nmark.0=abc\ngrid.bpm.0=120\n[0]\nlayer=\nframe=5\n");
+	EXPECT(model.has_value());
+	if (!model) return;
+	auto const& s = model->scenes[0];
+	EXPECT(s.rate == 60);
+	EXPECT(s.marks.empty() && s.bpm.empty());
+	EXPECT(s.objects.size() == 1 && s.objects[0].layer == 0 && s.objects[0].start == 5 && s.objects[0].end == 5);
+}
+
+static void test_utf8()
+{
+	EXPECT(aup2::from_utf8("a\xc3\xa9\xe3\x81\x82") == L"a\u00e9\u3042");
+	std::wstring const emoji = aup2::from_utf8("\xf0\x9f\x8e\xb5");
+	if constexpr (sizeof(wchar_t) == 2) EXPECT(emoji == L"\xd83c\xdfb5");
+	else EXPECT(emoji.size() == 1 && emoji[0] == static_cast<wchar_t>(0x1f3b5));
+}
+
+static int summarize(char const* path)
+{
+	auto const model = aup2::load(path);
+	if (!model) {
+		std::fprintf(stderr, "%s: failed to load.\n", path);
+		return 1;
+	}
+	std::printf("%s:\n", path);
+	for (auto const& s : model->scenes) {
+		size_t sections = 0, hidden = 0, locked = 0;
+		for (auto const& o : s.objects) sections += o.section_num();
+		for (auto const& [_, l] : s.layers) { hidden += !l.enable; locked += l.lock; }
+		std::printf("  scene %d: %zu objects (%zu sections), layers 0-%d (%zu hidden, %zu locked), frames 0-%d, %zu marks, %zu bpm grids\n",
+			s.id, s.objects.size(), sections, s.layer_max(), hidden, locked, s.frame_max(), s.marks.size(), s.bpm.size());
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1) {
+		int ret = 0;
+		for (int i = 1; i < argc; i++) ret |= summarize(argv[i]);
+		return ret;
+	}
+
+	test_sample();
+	test_invalid();
+	test_utf8();
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%d failure(s).\n", failures);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,181 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cstdio>
+#include <vector>
+#include <random>
+
+#include "cursor_history.hpp"
+#include "cursor_replay.hpp"
+
+static int failures = 0;
+#define EXPECT(cond) ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond), failures++))
+
+using replay::event;
+
+static void test_history()
+{
+	undo_history<int> h{ 4 };
+	h.clear(0);
+	EXPECT(!h.check_forward(0));
+	for (int i = 1; i <= 5; i++) EXPECT(h.check_forward(i));
+	EXPECT(h.size() == 4);
+	EXPECT(h.backward() == 4);
+	EXPECT(h.backward() == 3);
+	int v = 0;
+	EXPECT(h.repush(v) && v == 4);
+	EXPECT(h.entries() == (std::vector<int>{ 2, 3, 4, 5 }));
+	EXPECT(h.position() == 3);
+
+	// a new entry discards the ones for redo.
+	h.forward(9);
+	EXPECT(!h.repush(v));
+	EXPECT(h.entries() == (std::vector<int>{ 2, 3, 4, 9 }));
+}
+
+static void test_cooltime()
+{
+	// seeks 100 ms apart are skipped within 0.5 seconds from the last recorded one.
+	std::vector<event> const events = { { 1000, 10 }, { 1100, 50 }, { 1300, 20 }, { 1600, 80 }, { 1650, 80 } };
+	auto const s = replay::run(events, 0.5);
+	EXPECT(s.recorded == 2);
+	EXPECT(s.cooltime == 3);
+	EXPECT(s.entries == 3);
+
+	// no cooltime records every change of the position.
+	auto const s0 = replay::run(events, 0.0);
+	EXPECT(s0.recorded == 4);
+	EXPECT(s0.unchanged == 1);
+	EXPECT(s0.entries == 5);
+}
+
+static void test_settle()
+{
+	// playback is suspended, and a single entry is recorded when it stops.
+	std::vector<event> events{};
+	uint64_t t = 1000; int frame = 100;
+	replay::playback(events, t, frame, 30, 3000);
+	auto const s = replay::run(events, 0.5);
+	EXPECT(s.playback == events.size() - 5);
+	EXPECT(s.settled == 1);
+	EXPECT(s.entries == 3); // initial, the start of playback, and the end.
+
+	// a seek right after the playback is in the cooltime of the settled entry,
+	// but one later than that is recorded.
+	events.push_back({ t + 400, 10 });
+	events.push_back({ t + 1200, 20 });
+	auto const s2 = replay::run(events, 0.5);
+	EXPECT(s2.settled == 1);
+	EXPECT(s2.entries == 4);
+}
+
+static void test_detector()
+{
+	// playback at 240 fps is detected at the 6th frame, by 4 steps as regular as the one before.
+	playback_detector d{};
+	for (int k = 0; k < 5; k++) EXPECT(!d.step(1000 + k * 1000 / 240, 100 + k));
+	EXPECT(d.step(1000 + 5 * 1000 / 240, 105));
+
+	// holding an arrow key with a slow key repeat isn't.
+	d.reset();
+	for (int k = 0; k < 20; k++) EXPECT(!d.step(2000 + k * 130, 10 + k));
+
+	// neither quick seeks in irregular steps, nor backward ones.
+	d.reset();
+	int const frames[] = { 10, 20, 25, 30, 45, 60, 50, 40, 30, 20, 10 };
+	for (int k = 0; k < 11; k++) EXPECT(!d.step(3000 + k * 30, frames[k]));
+
+	// an irregular step breaks the run.
+	d.reset();
+	for (int k = 0; k < 4; k++) EXPECT(!d.step(4000 + k * 10, k));
+	EXPECT(!d.step(4040, 10));
+	EXPECT(!d.step(4050, 11));
+}
+
+static void test_playback_flood()
+{
+	// playback at 240 fps with seeks in between doesn't flood the history,
+	// while all the seeks apart more than the cooltime are recorded.
+	std::vector<event> events{};
+	std::mt19937 rng{ 240 };
+	uint64_t t = 1000; int frame = 0;
+	size_t const rounds = 10, seeks = 8;
+	for (size_t round = 0; round < rounds; round++) {
+		replay::seeks(events, t, frame, rng, seeks, 600, 1500);
+		t += 600;
+		replay::playback(events, t, frame, 240, 10000);
+		t += 600;
+	}
+	auto const s = replay::run(events, 0.5);
+	EXPECT(events.size() > 20000);
+	EXPECT(s.cooltime == rounds * 4); // the frames until playback is detected.
+	EXPECT(s.settled == rounds);
+	EXPECT(s.recorded == rounds * seeks);
+	// playback starts from the cursor, so its first frame is the same as the last seek.
+	EXPECT(s.unchanged == rounds);
+	// the initial, the seeks and where each playback stopped.
+	EXPECT(s.entries == 1 + rounds * (seeks + 1));
+}
+
+static void test_cursor_state()
+{
+	struct info { int layer, frame, display_layer_start, display_frame_start; };
+
+	// the view is kept relative to the cursor.
+	auto const a = cursor_state::from(info{ 12, 54321, 3, 50000 });
+	EXPECT(a.layer == 12 && a.frame == 54321);
+	EXPECT(a.view_layer() == 3 && a.view_frame() == 50000);
+	EXPECT(cursor_state::from(info{ 0, 0, 0, 0 }).view_frame() == 0);
+
+	// scrolling alone isn't a new position.
+	EXPECT(a == cursor_state::from(info{ 12, 54321, 0, 0 }));
+	EXPECT(!(a == cursor_state::from(info{ 11, 54321, 3, 50000 })));
+
+	// out of range values are clamped, keeping the cursor.
+	auto const far = cursor_state::from(info{ 500, 3000000, 0, 0 });
+	EXPECT(far.layer == 500 && far.frame == 3000000);
+	EXPECT(far.view_layer() == 500 - 128 && far.view_frame() == 3000000 - (1 << 19));
+	auto const huge = cursor_state::from(info{ 1 << 20, 1 << 30, 0, 0 });
+	EXPECT(huge.layer == (1 << 11) - 1 && huge.frame == (1 << 23) - 1);
+}
+
+static void test_budget()
+{
+	// full histories of 256 entries take 2 KiB each, and are evicted from the oldest.
+	undo_bundle<int, cursor_state> b{ 256, 64 << 10 };
+	for (int scene = 0; scene < 40; scene++) {
+		b.set_key(scene, {});
+		for (int k = 1; k <= 256; k++) b.check_forward(cursor_state::make(0, k, 0, 0));
+	}
+	EXPECT(b.current()->memory_size() == 256 * 8);
+	size_t scenes = 0;
+	b.for_each([&](int scene, auto const&) { scenes++; EXPECT(scene >= 8); });
+	EXPECT(scenes == 32);
+}
+
+int main()
+{
+	test_history();
+	test_cursor_state();
+	test_budget();
+	test_cooltime();
+	test_settle();
+	test_detector();
+	test_playback_flood();
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%d failure(s).\n", failures);
+		return 1;
+	}
+	return 0;
+}
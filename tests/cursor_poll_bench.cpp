@@ -0,0 +1,90 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+// replays streams of CHANGE_EDIT_FRAME notifications for several values of
+// `polling_cooltime`, and reports the entries produced and the cost per notification.
+//   cursor_poll_bench [stream.txt...]
+// each line of a stream is "<time in ms> <frame>", such as the verbose log converted.
+// without arguments, synthetic editing sessions are used.
+
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include "cursor_replay.hpp"
+
+static std::vector<replay::event> read_stream(char const* path)
+{
+	std::vector<replay::event> ret{};
+	std::ifstream in{ path };
+	for (std::string line; std::getline(in, line); ) {
+		std::istringstream ss{ line };
+		replay::event e{};
+		if (ss >> e.time >> e.frame) ret.push_back(e);
+	}
+	return ret;
+}
+
+static void report(char const* name, std::vector<replay::event> const& events)
+{
+	std::printf("%s: %zu events\n", name, events.size());
+	std::printf("  %8s %8s %8s %8s %8s %10s\n", "cooltime", "entries", "skipped", "playback", "settled", "ns/event");
+	for (double cooltime : { 0.0, 0.1, 0.25, 0.5, 1.0, 2.0 }) {
+		constexpr int reps = 20;
+		replay::stats s{};
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int k = 0; k < reps; k++) s = replay::run(events, cooltime);
+		auto const ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+		std::printf("  %8.2f %8zu %8zu %8zu %8zu %10.1f\n", cooltime, s.entries, s.cooltime, s.playback, s.settled,
+			events.empty() ? 0.0 : ns / reps / events.size());
+	}
+}
+
+// histories kept in the default budget of 1 MiB, filled up to the default queue size.
+template<class ValT>
+static void report_memory(char const* name, ValT const& v)
+{
+	constexpr size_t queue_size = 256, budget = 1 << 20;
+	undo_bundle<int, ValT> b{ queue_size, budget };
+	size_t scenes = 0;
+	for (int scene = 0; scene < 4096; scene++) {
+		b.set_key(scene, v);
+		for (size_t k = 0; k < queue_size; k++) b.current()->forward(v);
+		b.check_forward(v); // let it evict as the buffer has grown.
+	}
+	b.for_each([&](int, auto const&) { scenes++; });
+	std::printf("  %-24s %2zu bytes/entry, %4zu scenes (%zu entries) in 1 MiB\n",
+		name, sizeof(ValT), scenes, scenes * queue_size);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1) {
+		for (int i = 1; i < argc; i++) report(argv[i], read_stream(argv[i]));
+		return 0;
+	}
+	report("session at 30 fps", replay::session(30, 1));
+	report("session at 60 fps", replay::session(60, 2));
+	report("session at 240 fps", replay::session(240, 3));
+
+	// the entries of the cursor history, and the unpacked one of the older versions.
+	struct unpacked { int32_t frame; int16_t layer, view_layer; int32_t view_frame; bool operator==(unpacked const&) const = default; };
+	std::printf("memory:\n");
+	report_memory("cursor_state", cursor_state{});
+	report_memory("unpacked (version 2)", unpacked{});
+	report_memory("frame only (int)", 0);
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <random>
+
+#include "cursor_history.hpp"
+
+// replays streams of CHANGE_EDIT_FRAME notifications against the cursor poller,
+// with a clock driven by the timestamps in the stream.
+namespace replay
+{
+	struct manual_clock {
+		static inline uint64_t t = 0;
+		static uint64_t now() { return t; }
+	};
+
+	struct position {
+		int frame;
+		constexpr bool operator==(position const&) const = default;
+	};
+	using bundle = cooltime_undo_bundle<int, position, manual_clock>;
+	using poller = cursor_poller<int, position, manual_clock>;
+
+	// a notification at `time` in milliseconds.
+	struct event {
+		uint64_t time;
+		int frame;
+	};
+
+	struct stats {
+		size_t entries; // size of the history after the replay, including the initial one.
+		size_t recorded, unchanged, cooltime, playback, settled;
+	};
+
+	constexpr uint64_t settle_check_interval = 150; // same as the plugin's timer.
+
+	inline stats run(std::vector<event> const& events, double cooltime)
+	{
+		bundle b{ 1 << 20, ~size_t{ 0 }, cooltime };
+		poller p{ b };
+		manual_clock::t = events.empty() ? 1 : events.front().time;
+		b.set_key(0, { 0 });
+		b.reset_cooltime();
+
+		stats s{};
+		uint64_t next_check = 0;
+		int frame = 0;
+		auto const settle_until = [&](uint64_t t) {
+			// fire the settle timer as the plugin does.
+			while (p.playing() && next_check <= t) {
+				manual_clock::t = next_check;
+				if (p.check_settled([&] { return position{ frame }; })) s.settled++;
+				next_check += settle_check_interval;
+			}
+		};
+		for (auto const& e : events) {
+			settle_until(e.time);
+			manual_clock::t = e.time;
+			frame = e.frame;
+			switch (p.on_frame_changed([&] { return position{ frame }; })) {
+				using enum poller::result;
+			case recorded: s.recorded++; break;
+			case unchanged: s.unchanged++; break;
+			case cooltime: s.cooltime++; break;
+			case playback: s.playback++; break;
+			case playback_begun:
+				s.playback++;
+				next_check = e.time + settle_check_interval;
+				break;
+			}
+		}
+		settle_until(~uint64_t{ 0 } - settle_check_interval);
+		s.entries = b.current()->size();
+		return s;
+	}
+
+	// synthetic streams, starting at 1 second.
+
+	// playback at `fps` for `duration` milliseconds from `frame`.
+	inline void playback(std::vector<event>& out, uint64_t& t, int& frame, double fps, uint64_t duration)
+	{
+		uint64_t const t0 = t;
+		for (int k = 0; ; k++) {
+			uint64_t const tk = t0 + static_cast<uint64_t>(k * 1000 / fps);
+			if (tk >= t0 + duration) break;
+			out.push_back({ tk, frame++ });
+			t = tk;
+		}
+	}
+
+	// manual seeks by clicks or shortcut keys, at irregular intervals.
+	inline void seeks(std::vector<event>& out, uint64_t& t, int& frame, std::mt19937& rng, size_t count,
+		uint64_t min_interval, uint64_t max_interval)
+	{
+		std::uniform_int_distribution<uint64_t> interval{ min_interval, max_interval };
+		std::uniform_int_distribution<int> jump{ -600, 600 };
+		for (size_t k = 0; k < count; k++) {
+			t += interval(rng);
+			int d = jump(rng); if (d == 0) d = 1;
+			frame = std::max(0, frame + d);
+			out.push_back({ t, frame });
+		}
+	}
+
+	// an editing session: seeks, playbacks, and seeks in between.
+	inline std::vector<event> session(double fps, uint32_t seed)
+	{
+		std::vector<event> ret{};
+		std::mt19937 rng{ seed };
+		uint64_t t = 1000; int frame = 0;
+		for (int round = 0; round < 20; round++) {
+			seeks(ret, t, frame, rng, 30, 80, 1500);
+			t += 500;
+			playback(ret, t, frame, fps, 5000);
+			t += 1000;
+		}
+		return ret;
+	}
+}
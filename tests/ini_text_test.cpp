@@ -0,0 +1,124 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "ini_text.hpp"
+
+static int failures = 0;
+#define EXPECT(cond) ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond), failures++))
+
+static void test_get()
+{
+	ini_text ini{};
+	ini.parse(L"; comment\r\n[search]\r\npage_rate = 0.5 \r\nbpm_grid_div=4\r\n\r\n[Trace]\r\nenabled=1\r\n");
+
+	EXPECT(ini.get(L"search", L"page_rate") == L"0.5");
+	EXPECT(ini.get(L"SEARCH", L"Bpm_Grid_Div") == L"4");
+	EXPECT(ini.get(L"trace", L"enabled") == L"1");
+	EXPECT(!ini.get(L"search", L"enabled"));
+	EXPECT(!ini.get(L"missing", L"page_rate"));
+
+	EXPECT(ini.get_int(L"search", L"bpm_grid_div", -1) == 4);
+	EXPECT(ini.get_int(L"search", L"page_rate", -1) == 0);
+	EXPECT(ini.get_int(L"search", L"missing", -1) == -1);
+}
+
+static void test_invalid_int()
+{
+	ini_text ini{};
+	ini.parse(L"[a]\nempty=\ntext=abc\nnegative=-12xyz\n");
+
+	EXPECT(ini.get_int(L"a", L"empty", 7) == 7);
+	EXPECT(ini.get_int(L"a", L"text", 7) == 7);
+	EXPECT(ini.get_int(L"a", L"negative", 7) == -12);
+}
+
+static void test_round_trip()
+{
+	// unknown keys, comments and blank lines survive, with CRLF endings.
+	std::wstring_view const src = L"; header\r\n[a]\r\nx=1\r\n\r\n; note\r\n[b]\r\nunknown = keep me\r\n";
+	ini_text ini{};
+	ini.parse(src);
+	EXPECT(ini.text() == src);
+
+	// LF-only input is written back with CRLF.
+	ini.parse(L"[a]\nx=1\n");
+	EXPECT(ini.text() == L"[a]\r\nx=1\r\n");
+
+	// no trailing newline.
+	ini.parse(L"[a]\r\nx=1");
+	EXPECT(ini.text() == L"[a]\r\nx=1\r\n");
+
+	ini.parse(L"");
+	EXPECT(ini.text().empty());
+}
+
+static void test_set()
+{
+	ini_text ini{};
+	ini.parse(L"[a]\r\nx=1\r\n; between\r\n[b]\r\ny=2\r\n");
+
+	// overwrite in place, keeping the original spelling of the key.
+	ini.set(L"A", L"X", L"10");
+	EXPECT(ini.get(L"a", L"x") == L"10");
+
+	// a new key goes after the last key of its section.
+	ini.set(L"a", L"z", L"3");
+	// a new section goes to the end.
+	ini.set(L"c", L"w", L"4");
+	ini.set(L"c", L"v", L"5");
+	EXPECT(ini.text() == L"[a]\r\nx=10\r\nz=3\r\n; between\r\n[b]\r\ny=2\r\n[c]\r\nw=4\r\nv=5\r\n");
+
+	// the lines of later entries are shifted by insertions.
+	ini.set(L"b", L"y", L"20");
+	ini.set(L"c", L"v", L"50");
+	EXPECT(ini.text() == L"[a]\r\nx=10\r\nz=3\r\n; between\r\n[b]\r\ny=20\r\n[c]\r\nw=4\r\nv=50\r\n");
+
+	// a section without keys.
+	ini.parse(L"[empty]\r\n[other]\r\nk=1\r\n");
+	ini.set(L"empty", L"k", L"2");
+	EXPECT(ini.text() == L"[empty]\r\nk=2\r\n[other]\r\nk=1\r\n");
+	EXPECT(ini.get(L"other", L"k") == L"1");
+
+	// starting from nothing.
+	ini.parse(L"");
+	ini.set(L"s", L"k", L"v");
+	EXPECT(ini.text() == L"[s]\r\nk=v\r\n");
+}
+
+static void test_comments()
+{
+	ini_text ini{};
+	ini.parse(L"[a]\r\n;x=1\r\n  ; y=2\r\nz=3 ; not a comment\r\n");
+
+	EXPECT(!ini.get(L"a", L"x"));
+	EXPECT(!ini.get(L"a", L"y"));
+	EXPECT(ini.get(L"a", L"z") == L"3 ; not a comment");
+}
+
+int main()
+{
+	test_get();
+	test_invalid_int();
+	test_round_trip();
+	test_set();
+	test_comments();
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%d failure(s).\n", failures);
+		return 1;
+	}
+	return 0;
+}
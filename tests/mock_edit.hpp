@@ -0,0 +1,49 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+
+#include "timeline_model.hpp"
+
+// EDIT_SECTION over a scene of timeline_model, counting the calls to the host.
+struct mock_edit {
+	struct info_t { int frame_max, layer_max; };
+	struct layer_frame { int layer, start, end; };
+	using handle = timeline_model::object const*;
+
+	timeline_model::scene const& scene;
+	info_t const info_v;
+	info_t const* const info = &info_v;
+	size_t calls = 0;
+
+	// the first object on the layer that ends at or after the frame, as the host does.
+	handle find_object(int layer, int frame)
+	{
+		calls++;
+		auto const& objs = scene.objects;
+		auto const it = std::partition_point(objs.begin(), objs.end(),
+			[&](auto const& o) { return o.layer < layer || (o.layer == layer && o.end < frame); });
+		return it != objs.end() && it->layer == layer ? &*it : nullptr;
+	}
+	layer_frame get_object_layer_frame(handle obj) { calls++; return { obj->layer, obj->start, obj->end }; }
+	int get_object_section_num(handle obj) { calls++; return obj->section_num(); }
+	int get_object_section_frame(handle obj, int i) { calls++; return obj->sections[i - 1]; }
+	bool get_layer_enable(int layer) { calls++; return scene.layer_at(layer).enable; }
+	bool get_layer_lock(int layer) { calls++; return scene.layer_at(layer).lock; }
+
+	mock_edit(timeline_model::scene const& scene)
+		: scene{ scene }, info_v{ scene.frame_max(), scene.layer_max() } {}
+};
@@ -0,0 +1,200 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+// runs the "jump-over" searches of moving and duplicating objects on pathological timelines,
+// and reports the rounds against their bound, the calls to the host for the bound and the search, and the time.
+// they are also compared with brute-force references on random timelines.
+//   space_search_bench [seed [objects]]
+// the layouts have up to `objects` (10000 by default) objects to jump over.
+
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <utility>
+#include <limits>
+
+#include "timeline_search.hpp"
+#include "timeline_model.hpp"
+#include "mock_edit.hpp"
+
+static int failures = 0;
+#define EXPECT(cond) ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond), failures++))
+
+// never runs out of time, so only the bound of rounds can truncate.
+struct frozen_clock {
+	static uint64_t now() { return 0; }
+};
+using budget_t = search_budget<frozen_clock>;
+constexpr size_t no_cap = std::numeric_limits<size_t>::max();
+
+using targets_t = std::vector<std::pair<mock_edit::handle, mock_edit::layer_frame>>;
+static targets_t targets_of(std::vector<timeline_model::object> const& objs, std::vector<bool> const& picked)
+{
+	targets_t ret{};
+	for (size_t i = 0; i < objs.size(); i++)
+		if (picked[i]) ret.push_back({ &objs[i], { objs[i].layer, objs[i].start, objs[i].end } });
+	return ret;
+}
+
+////////////////////////////////
+// references.
+////////////////////////////////
+static bool fits(timeline_model::scene const& scene, targets_t const& targets, bool include_targets, int ofs)
+{
+	for (auto const& [t, pos] : targets) {
+		for (auto const& o : scene.objects) {
+			if (o.layer != pos.layer) continue;
+			if (!include_targets && std::ranges::any_of(targets, [&](auto const& p) { return p.first == &o; })) continue;
+			if (std::max(pos.start + ofs, o.start) <= std::min(pos.end + ofs, o.end)) return false;
+		}
+	}
+	return true;
+}
+static int ref_space_left(timeline_model::scene const& scene, targets_t const& targets, int limit)
+{
+	for (int ofs = 2; ofs <= limit; ofs++)
+		if (fits(scene, targets, false, -ofs)) return ofs;
+	return 0;
+}
+static int ref_space_right(timeline_model::scene const& scene, targets_t const& targets, bool include_targets, int ofs)
+{
+	while (!fits(scene, targets, include_targets, ofs)) ofs++;
+	return ofs;
+}
+
+////////////////////////////////
+// pathological timelines.
+////////////////////////////////
+// targets of `width` frames on each of `layers` layers, and `count` one-frame objects
+// forbidding a chain of offsets one after another, so the nearest space is at `count * width + 1`.
+// the chain runs from the last layer to the first, against the order the targets are visited,
+// so most rounds pass only a single object.
+static timeline_model::scene staggered(int count, int layers, int width, bool forward, targets_t& targets)
+{
+	timeline_model::scene scene{};
+	int const origin = forward ? 0 : (count + 1) * width + 1;
+	for (int a = 0; a < count; a++) {
+		int const layer = layers - 1 - a % layers;
+		int const frame = forward ? (a + 1) * width : origin - a * width - 1;
+		scene.objects.push_back({ layer, frame, frame, {} });
+	}
+	for (int layer = 0; layer < layers; layer++)
+		scene.objects.push_back({ layer, origin, origin + width - 1, {} });
+	scene.normalize();
+
+	targets.clear();
+	for (auto const& o : scene.objects)
+		if (o.start == origin) targets.push_back({ &o, { o.layer, o.start, o.end } });
+	return scene;
+}
+
+static void bench(int max_count)
+{
+	constexpr int width = 10;
+	std::printf("staggered layouts (width %d):\n", width);
+	std::printf("  %-10s %8s %6s %8s %8s %10s %10s %8s\n", "search", "objects", "layers", "rounds", "bound", "calls (b)", "calls (s)", "ms");
+	for (int count = 1000; count <= max_count; count *= 10) {
+		for (int layers : { 1, 4, 16 }) {
+			for (int kind = 0; kind < 3; kind++) {
+				bool const forward = kind > 0, duplicate = kind == 2;
+				targets_t targets{};
+				auto const scene = staggered(count, layers, width, forward, targets);
+				mock_edit edit{ scene };
+				auto const is_target = [&](mock_edit::handle o) { return !duplicate && o->start == targets.front().second.start; };
+
+				auto const t0 = std::chrono::steady_clock::now();
+				budget_t budget{ jump_over_rounds(&edit, targets, is_target, forward, no_cap) };
+				size_t const bound_calls = edit.calls;
+				int const ofs = !forward ? find_space_left(&edit, targets, is_target, targets.front().second.start, budget) :
+					find_space_right(&edit, targets, is_target, duplicate ? width : 2, budget);
+				double const ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+				EXPECT(ofs == count * width + 1);
+				EXPECT(budget.truncated == budget_t::cause::none);
+				std::printf("  %-10s %8d %6d %8zu %8zu %10zu %10zu %8.2f\n", !forward ? "left" : duplicate ? "duplicate" : "right",
+					count, layers, budget.rounds, budget.rounds_max, bound_calls, edit.calls - bound_calls, ms);
+			}
+		}
+	}
+}
+
+////////////////////////////////
+// random timelines.
+////////////////////////////////
+static void test_random(uint32_t seed)
+{
+	std::mt19937 rng{ seed };
+	auto const random = [&](int lo, int hi) { return std::uniform_int_distribution<int>{ lo, hi }(rng); };
+	for (int round = 0; round < 1000; round++) {
+		timeline_model::scene scene{};
+		int const layers = random(1, 4);
+		for (int layer = 0; layer < layers; layer++) {
+			for (int frame = random(0, 20), n = random(0, 12); n > 0; n--) {
+				int const len = random(1, 15);
+				scene.objects.push_back({ layer, frame, frame + len - 1, {} });
+				frame += len + (random(0, 2) == 0 ? 0 : random(1, 20));
+			}
+		}
+		scene.normalize();
+		if (scene.objects.empty()) continue;
+
+		std::vector<bool> picked(scene.objects.size());
+		for (size_t i = 0; i < picked.size(); i++) picked[i] = random(0, 3) == 0;
+		picked[static_cast<size_t>(random(0, static_cast<int>(picked.size()) - 1))] = true;
+		auto const targets = targets_of(scene.objects, picked);
+		auto const is_target = [&](mock_edit::handle o) { return picked[static_cast<size_t>(o - scene.objects.data())]; };
+		int frame_min = std::numeric_limits<int>::max(), width = 0;
+		for (auto const& [_, pos] : targets) {
+			frame_min = std::min(frame_min, pos.start);
+			width = std::max(width, pos.end + 1 - pos.start);
+		}
+
+		// every search ends within its bound, hence never truncated by it.
+		mock_edit edit{ scene };
+		budget_t left{ jump_over_rounds(&edit, targets, is_target, false, no_cap) };
+		EXPECT(find_space_left(&edit, targets, is_target, frame_min, left) == ref_space_left(scene, targets, frame_min));
+		EXPECT(left.truncated == budget_t::cause::none);
+
+		budget_t right{ jump_over_rounds(&edit, targets, is_target, true, no_cap) };
+		EXPECT(find_space_right(&edit, targets, is_target, 2, right) == ref_space_right(scene, targets, false, 2));
+		EXPECT(right.truncated == budget_t::cause::none);
+
+		constexpr auto never = [](mock_edit::handle) { return false; };
+		budget_t dup{ jump_over_rounds(&edit, targets, never, true, no_cap) };
+		EXPECT(find_space_right(&edit, targets, never, width, dup) == ref_space_right(scene, targets, true, width));
+		EXPECT(dup.truncated == budget_t::cause::none);
+
+		if (failures > 0) {
+			std::fprintf(stderr, "mismatch at round %d (seed %u).\n", round, seed);
+			return;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t const seed = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 20260401;
+	int const max_count = argc > 2 ? std::stoi(argv[2]) : 10000;
+
+	test_random(seed);
+	bench(max_count);
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%d failure(s).\n", failures);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <string>
+
+// in-memory model of the timeline of a project, for running the commands offline.
+// layers and frames are 0-based as in EDIT_SECTION.
+struct timeline_model {
+	struct object {
+		int layer, start, end; // `end` is inclusive.
+		std::vector<int> sections; // the first frames of the 2nd and later sections, for mid-points.
+
+		// number of sections, as get_object_section_num().
+		int section_num() const { return static_cast<int>(sections.size()) + 1; }
+	};
+	struct layer_state {
+		bool enable = true, lock = false;
+	};
+	struct mark {
+		int frame;
+		std::wstring memo;
+	};
+	struct bpm_grid {
+		float tempo;
+		int beat;
+		float offset; // in seconds.
+		double start; // in seconds.
+	};
+
+	struct scene {
+		int id = 0;
+		std::wstring name{};
+		int rate = 60, scale = 1;
+		int frame = 0, layer = 0; // the cursor.
+		std::vector<object> objects{}; // sorted by layer and then by start.
+		std::map<int, layer_state> layers{}; // ones not in this map are in the default state.
+		std::vector<mark> marks{}; // sorted by frame.
+		std::vector<bpm_grid> bpm{}; // sorted by start.
+
+		layer_state layer_at(int l) const
+		{
+			auto const it = layers.find(l);
+			return it != layers.end() ? it->second : layer_state{};
+		}
+		// the last frame and layer that have an object, or 0.
+		int frame_max() const
+		{
+			int ret = 0;
+			for (auto const& o : objects) ret = std::max(ret, o.end);
+			return ret;
+		}
+		int layer_max() const
+		{
+			int ret = 0;
+			for (auto const& o : objects) ret = std::max(ret, o.layer);
+			if (!layers.empty()) ret = std::max(ret, layers.rbegin()->first);
+			return ret;
+		}
+		// sorts the elements after they are added.
+		void normalize()
+		{
+			std::ranges::sort(objects, {}, [](object const& o) { return std::pair{ o.layer, o.start }; });
+			std::ranges::stable_sort(marks, {}, &mark::frame);
+			std::ranges::stable_sort(bpm, {}, &bpm_grid::start);
+		}
+	};
+
+	std::vector<scene> scenes{};
+
+	scene* find_scene(int id)
+	{
+		auto const it = std::ranges::find(scenes, id, &scene::id);
+		return it != scenes.end() ? &*it : nullptr;
+	}
+};
@@ -0,0 +1,285 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+// compares the timeline searches with brute-force references on random timelines.
+//   timeline_search_test [seed [seconds]]
+// a failing case is shrunk and printed in the .aup2 syntax, to be loaded by aup2_loader.hpp.
+
+#include <cstdio>
+#include <cstdint>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "timeline_search.hpp"
+#include "timeline_model.hpp"
+#include "mock_edit.hpp"
+
+static int failures = 0;
+#define EXPECT(cond) ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond), failures++))
+
+////////////////////////////////
+// references.
+////////////////////////////////
+static int ref_boundary(timeline_model::scene const& scene, int layer, int frame, bool forward, bool allow_midpt)
+{
+	int const frame_max = scene.frame_max();
+	if (forward && frame > frame_max) return frame_max;
+	int ret = forward ? frame_max : 0; bool found = false;
+	auto const consider = [&](int p) {
+		if (forward ? p < frame : p > frame) return;
+		if (!found || (forward ? p < ret : p > ret)) ret = p;
+		found = true;
+	};
+	for (auto const& o : scene.objects) {
+		if (o.layer != layer) continue;
+		consider(o.start); consider(o.end + 1);
+		if (allow_midpt) for (int s : o.sections) consider(s);
+	}
+	return ret;
+}
+
+static int ref_scene_boundary(timeline_model::scene const& scene, int frame, bool forward, bool allow_midpt, ignore_layer mode)
+{
+	int ret = forward ? scene.frame_max() : 0;
+	for (int layer = 0; layer <= scene.layer_max(); layer++) {
+		auto const state = scene.layer_at(layer);
+		if ((std::to_underlying(mode) & 1) != 0 && !state.enable) continue;
+		if ((std::to_underlying(mode) & 2) != 0 && state.lock) continue;
+		int const f = ref_boundary(scene, layer, frame, forward, allow_midpt);
+		ret = forward ? std::min(ret, f) : std::max(ret, f);
+	}
+	return ret;
+}
+
+static int ref_neighbor_mark(std::vector<int> const& marks, int frame, bool forward, int frame_max)
+{
+	int ret = forward ? frame_max : 0; bool found = false;
+	for (int m : marks) {
+		if (forward ? m <= frame : m >= frame) continue;
+		if (!found || (forward ? m < ret : m > ret)) ret = m;
+		found = true;
+	}
+	return ret;
+}
+
+////////////////////////////////
+// random timelines.
+////////////////////////////////
+static timeline_model::scene random_scene(std::mt19937& rng)
+{
+	auto const random = [&](int lo, int hi) { return std::uniform_int_distribution<int>{ lo, hi }(rng); };
+	timeline_model::scene scene{};
+	int const layers = random(1, 10);
+	for (int layer = 0; layer < layers; layer++) {
+		// objects in clusters of adjacent ones, with gaps of various lengths between.
+		int frame = random(0, 30), count = random(0, 25);
+		for (int i = 0; i < count; i++) {
+			int const len = random(0, 3) == 0 ? random(1, 3) : random(1, 200);
+			timeline_model::object o{ .layer = layer, .start = frame, .end = frame + len - 1 };
+			if (len >= 3 && random(0, 3) == 0) {
+				for (int s = o.start + 1; s <= o.end; s++)
+					if (random(0, len / 2) == 0) o.sections.push_back(s);
+			}
+			scene.objects.push_back(std::move(o));
+			frame += len + (random(0, 2) == 0 ? 0 : random(1, 300));
+		}
+		if (random(0, 3) == 0) scene.layers[layer] = { .enable = random(0, 1) != 0, .lock = random(0, 1) != 0 };
+	}
+	scene.normalize();
+	return scene;
+}
+
+static void print_scene(timeline_model::scene const& scene)
+{
+	std::fprintf(stderr, "[scene.0]\n");
+	for (auto const& [layer, state] : scene.layers)
+		std::fprintf(stderr, "layer.%d.enable=%d\nlayer.%d.lock=%d\n", layer, state.enable, layer, state.lock);
+	int n = 0;
+	for (auto const& o : scene.objects) {
+		std::fprintf(stderr, "[%d]\nlayer=%d\nframe=%d", n++, o.layer, o.start);
+		for (int s : o.sections) std::fprintf(stderr, ",%d", s);
+		std::fprintf(stderr, ",%d\n", o.end);
+	}
+}
+
+////////////////////////////////
+// tests.
+////////////////////////////////
+struct query {
+	int layer; // negative for the entire scene.
+	int frame;
+	bool forward, allow_midpt;
+	ignore_layer mode;
+};
+
+// returns an empty string if the searches agree with the references within the bound of calls.
+static std::string check(timeline_model::scene const& scene, query const& q)
+{
+	mock_edit edit{ scene };
+	int const actual = q.layer >= 0 ?
+		find_boundary(&edit, q.layer, q.frame, q.forward, q.allow_midpt) :
+		find_scene_boundary(&edit, q.frame, q.forward, q.allow_midpt, q.mode);
+	int const expected = q.layer >= 0 ?
+		ref_boundary(scene, q.layer, q.frame, q.forward, q.allow_midpt) :
+		ref_scene_boundary(scene, q.frame, q.forward, q.allow_midpt, q.mode);
+	if (actual != expected)
+		return "returned " + std::to_string(actual) + ", expected " + std::to_string(expected);
+
+	// the binary search keeps the calls logarithmic per layer, however many objects there are.
+	size_t const per_layer = 8 + 2 * std::bit_width(static_cast<unsigned>(edit.info->frame_max + 2))
+		+ (q.allow_midpt ? 64 : 0); // the sections of an object are read all at once.
+	size_t const bound = per_layer * (q.layer >= 0 ? 1 : edit.info->layer_max + 1);
+	if (edit.calls > bound)
+		return std::to_string(edit.calls) + " calls to the host, more than " + std::to_string(bound);
+	return {};
+}
+
+// removes objects, sections and layer states while the query still fails.
+static timeline_model::scene shrink(timeline_model::scene scene, query const& q)
+{
+	for (bool changed = true; changed; ) {
+		changed = false;
+		auto const try_change = [&](auto&& mutate) {
+			auto cand = scene;
+			mutate(cand);
+			if (check(cand, q).empty()) return false;
+			scene = std::move(cand);
+			return changed = true;
+		};
+		for (size_t i = scene.objects.size(); i-- > 0; )
+			try_change([&](auto& s) { s.objects.erase(s.objects.begin() + i); });
+		for (size_t i = 0; i < scene.objects.size(); i++) {
+			for (size_t j = scene.objects[i].sections.size(); j-- > 0; ) {
+				try_change([&](auto& s) {
+					auto& sec = s.objects[i].sections;
+					sec.erase(sec.begin() + j);
+				});
+			}
+		}
+		for (auto it = scene.layers.begin(); it != scene.layers.end(); ) {
+			int const layer = (it++)->first;
+			try_change([&](auto& s) { s.layers.erase(layer); });
+		}
+	}
+	return scene;
+}
+
+static void test_random(uint32_t seed, double seconds)
+{
+	std::mt19937 rng{ seed };
+	auto const deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+	size_t scenes = 0, queries = 0;
+	while (std::chrono::steady_clock::now() < deadline) {
+		auto const scene = random_scene(rng);
+		scenes++;
+		int const frame_max = scene.frame_max(), layer_max = scene.layer_max();
+
+		// frames at and around the edit points are the edge cases.
+		std::vector<int> frames{ -1, 0, frame_max, frame_max + 1 };
+		for (auto const& o : scene.objects) {
+			for (int d : { -1, 0, 1 }) {
+				frames.push_back(o.start + d);
+				frames.push_back(o.end + 1 + d);
+			}
+			for (int s : o.sections) frames.push_back(s + (static_cast<int>(rng() % 3) - 1));
+		}
+		for (int i = 0; i < 64; i++) {
+			frames.push_back(std::uniform_int_distribution<int>{ -2, frame_max + 2 }(rng));
+
+			query const q{
+				.layer = rng() % 4 == 0 ? -1 : static_cast<int>(rng() % (layer_max + 1)),
+				.frame = frames[rng() % frames.size()],
+				.forward = rng() % 2 == 0,
+				.allow_midpt = rng() % 2 == 0,
+				.mode = static_cast<ignore_layer>(rng() % 4),
+			};
+			queries++;
+			if (auto const err = check(scene, q); !err.empty()) {
+				auto const small = shrink(scene, q);
+				std::fprintf(stderr, "mismatch (seed %u): layer %d, frame %d, %s, midpoints %d, ignore %u: %s\n",
+					seed, q.layer, q.frame, q.forward ? "forward" : "backward", q.allow_midpt,
+					std::to_underlying(q.mode), check(small, q).c_str());
+				print_scene(small);
+				failures++;
+				return;
+			}
+		}
+	}
+	std::printf("%zu scenes, %zu queries in %.1f seconds.\n", scenes, queries, seconds);
+}
+
+static void test_marks_and_bpm(uint32_t seed)
+{
+	struct bpm { float tempo; int beat; float offset; double start; };
+	std::mt19937 rng{ seed };
+	auto const random = [&](int lo, int hi) { return std::uniform_int_distribution<int>{ lo, hi }(rng); };
+	for (int round = 0; round < 2000; round++) {
+		// marks.
+		std::vector<int> marks{};
+		for (int f = random(0, 10), n = random(0, 12); n > 0; n--, f += random(1, 100)) marks.push_back(f);
+		int const frame_max = (marks.empty() ? 0 : marks.back()) + random(0, 50);
+		for (int frame = -2; frame <= frame_max + 2; frame += random(1, 7)) {
+			for (bool forward : { false, true })
+				EXPECT(find_neighbor_mark(marks, frame, forward, frame_max) == ref_neighbor_mark(marks, frame, forward, frame_max));
+		}
+
+		// bpm grids in ascending order: the last one starting at or before the time, or the first one.
+		std::vector<bpm> list{};
+		for (double t = random(0, 3) == 0 ? 0 : random(1, 20); list.size() < static_cast<size_t>(random(1, 6)); t += random(1, 30))
+			list.push_back({ 120.0f, 4, 0.0f, t });
+		int const rate = random(0, 1) == 0 ? 60 : 30000, scale = rate == 60 ? 1 : 1001;
+		for (int frame = 0; frame < 200 * rate / scale; frame += random(1, 97)) {
+			double const t = static_cast<double>(frame) * scale / rate;
+			size_t expected = 0;
+			for (size_t i = 1; i < list.size(); i++) if (list[i].start <= t) expected = i;
+			EXPECT(static_cast<size_t>(find_bpm_grid_at(list, frame, rate, scale) - list.begin()) == expected);
+		}
+	}
+}
+
+static void test_fixed()
+{
+	// a few cases by hand: [0,9] [10,19 with a mid-point at 15] on layer 0, [30,39] on layer 1 (locked).
+	timeline_model::scene scene{};
+	scene.objects = { { 0, 0, 9, {} }, { 0, 10, 19, { 15 } }, { 1, 30, 39, {} } };
+	scene.layers[1].lock = true;
+	mock_edit edit{ scene };
+	EXPECT(find_boundary(&edit, 0, 11, true, false) == 20);
+	EXPECT(find_boundary(&edit, 0, 11, true, true) == 15);
+	EXPECT(find_boundary(&edit, 0, 14, false, true) == 10);
+	EXPECT(find_boundary(&edit, 0, 25, false, true) == 20);
+	EXPECT(find_boundary(&edit, 0, 25, true, true) == 39);
+	EXPECT(find_scene_boundary(&edit, 21, true, false, ignore_layer::none) == 30);
+	EXPECT(find_scene_boundary(&edit, 21, true, false, ignore_layer::locked) == 39);
+	EXPECT(find_scene_boundary(&edit, 45, false, false, ignore_layer::hidden) == 40);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t const seed = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 20260401;
+	double const seconds = argc > 2 ? std::stod(argv[2]) : 2.0;
+
+	test_fixed();
+	test_marks_and_bpm(seed);
+	test_random(seed, seconds);
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%d failure(s).\n", failures);
+		return 1;
+	}
+	return 0;
+}
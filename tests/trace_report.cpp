@@ -0,0 +1,178 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+// prints the latencies of each command from a command trace file.
+//   trace_report tl_walkaround2.trace [...]
+// without arguments, it checks itself on a generated trace.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command_trace.hpp"
+
+static int failures = 0;
+#define EXPECT(cond) ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond), failures++))
+
+struct command_stats {
+	std::string name;
+	std::vector<double> durations; // in milliseconds, sorted.
+
+	// nearest-rank percentile.
+	double percentile(double p) const
+	{
+		if (durations.empty()) return 0;
+		size_t const rank = static_cast<size_t>(p / 100 * durations.size() + 0.999999);
+		return durations[std::clamp<size_t>(rank, 1, durations.size()) - 1];
+	}
+};
+
+static std::string utf16_to_utf8(std::u16string_view src)
+{
+	std::string ret{};
+	for (size_t i = 0; i < src.size(); i++) {
+		uint32_t cp = src[i];
+		if (0xd800 <= cp && cp < 0xdc00 && i + 1 < src.size())
+			cp = 0x10000 + ((cp - 0xd800) << 10) + (src[++i] - 0xdc00);
+		if (cp < 0x80) ret += static_cast<char>(cp);
+		else if (cp < 0x800) { ret += static_cast<char>(0xc0 | cp >> 6); ret += static_cast<char>(0x80 | (cp & 0x3f)); }
+		else if (cp < 0x10000) {
+			ret += static_cast<char>(0xe0 | cp >> 12); ret += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+			ret += static_cast<char>(0x80 | (cp & 0x3f));
+		}
+		else {
+			ret += static_cast<char>(0xf0 | cp >> 18); ret += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+			ret += static_cast<char>(0x80 | ((cp >> 6) & 0x3f)); ret += static_cast<char>(0x80 | (cp & 0x3f));
+		}
+	}
+	return ret;
+}
+
+// returns the statistics per command, or an empty vector if the data is invalid.
+// a truncated last record, as left by a crash, is ignored.
+static std::vector<command_stats> analyze(std::string_view data)
+{
+	using namespace command_trace;
+	file_header header;
+	if (data.size() < sizeof(header)) return {};
+	std::memcpy(&header, data.data(), sizeof(header));
+	data.remove_prefix(sizeof(header));
+	if (header.magic != magic || header.version != version
+		|| header.counter_frequency <= 0 || data.size() < header.names_size) return {};
+
+	// the names.
+	std::vector<command_stats> ret(header.edit_count + header.obj_count);
+	std::u16string names(header.names_size / sizeof(char16_t), u'\0');
+	std::memcpy(names.data(), data.data(), names.size() * sizeof(char16_t));
+	data.remove_prefix(header.names_size);
+	size_t pos = 0;
+	for (auto& c : ret) {
+		size_t const end = std::min(names.find(u'\0', pos), names.size());
+		c.name = utf16_to_utf8(std::u16string_view{ names }.substr(pos, end - pos));
+		pos = std::min(end + 1, names.size());
+	}
+
+	// the records.
+	for (; data.size() >= sizeof(record); data.remove_prefix(sizeof(record))) {
+		record rec;
+		std::memcpy(&rec, data.data(), sizeof(rec));
+		if (rec.command >= ret.size()) continue;
+		ret[rec.command].durations.push_back(1000.0 * rec.duration / header.counter_frequency);
+	}
+	for (auto& c : ret) std::ranges::sort(c.durations);
+	return ret;
+}
+
+static int report(char const* path)
+{
+	std::ifstream in{ path, std::ios::binary };
+	std::string const data{ std::istreambuf_iterator<char>{ in }, {} };
+	auto stats = analyze(data);
+	if (stats.empty()) {
+		std::fprintf(stderr, "%s: not a trace file.\n", path);
+		return 1;
+	}
+
+	// the slowest first.
+	std::erase_if(stats, [](auto const& c) { return c.durations.empty(); });
+	std::ranges::sort(stats, std::greater{}, [](auto const& c) { return c.percentile(99); });
+	std::printf("%s:\n%8s %10s %10s %10s %10s  %s\n", path, "count", "p50 (ms)", "p95 (ms)", "p99 (ms)", "max (ms)", "command");
+	for (auto const& c : stats) {
+		std::printf("%8zu %10.3f %10.3f %10.3f %10.3f  %s\n", c.durations.size(),
+			c.percentile(50), c.percentile(95), c.percentile(99), c.durations.back(), c.name.c_str());
+	}
+	return 0;
+}
+
+static void test_generated()
+{
+	using namespace command_trace;
+	using namespace std::string_literals;
+	std::u16string const names = u"左の編集点\0右の編集点\0obj\0"s;
+	file_header const header{
+		.magic = magic, .version = version, .counter_frequency = 10'000'000,
+		.edit_count = 2, .obj_count = 1,
+		.names_size = static_cast<uint32_t>(names.size() * sizeof(char16_t)), .reserved = 0,
+	};
+	std::string data(sizeof(header), '\0');
+	std::memcpy(data.data(), &header, sizeof(header));
+	data.append(reinterpret_cast<char const*>(names.data()), header.names_size);
+	auto const add = [&](uint16_t command, uint32_t ticks) {
+		record const rec{ .start = 0, .duration = ticks, .command = command };
+		data.append(reinterpret_cast<char const*>(&rec), sizeof(rec));
+	};
+	// command 0 takes 1..100 ms, command 2 takes 0.5 ms once.
+	for (uint32_t i = 100; i >= 1; i--) add(0, i * 10'000);
+	add(2, 5'000);
+	add(7, 1); // out of range, ignored.
+	data.append(10, '\0'); // truncated.
+
+	auto const stats = analyze(data);
+	EXPECT(stats.size() == 3);
+	if (stats.size() != 3) return;
+	EXPECT(stats[0].name == "\xe5\xb7\xa6\xe3\x81\xae\xe7\xb7\xa8\xe9\x9b\x86\xe7\x82\xb9"); // "左の編集点"
+	EXPECT(stats[2].name == "obj");
+	EXPECT(stats[0].durations.size() == 100);
+	EXPECT(stats[0].percentile(50) == 50.0);
+	EXPECT(stats[0].percentile(95) == 95.0);
+	EXPECT(stats[0].percentile(99) == 99.0);
+	EXPECT(stats[1].durations.empty() && stats[1].percentile(99) == 0);
+	EXPECT(stats[2].percentile(50) == 0.5 && stats[2].percentile(99) == 0.5);
+
+	// not a trace.
+	EXPECT(analyze("").empty());
+	EXPECT(analyze(std::string(64, 'x')).empty());
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1) {
+		int ret = 0;
+		for (int i = 1; i < argc; i++) ret |= report(argv[i]);
+		return ret;
+	}
+
+	test_generated();
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%d failure(s).\n", failures);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,329 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+#include <vector>
+
+// searches on the timeline through the interface of EDIT_SECTION, without the host.
+// `EditT` provides the members of EDIT_SECTION used here:
+//   info (frame_max and layer_max), find_object(), get_object_layer_frame(),
+//   get_object_section_num(), get_object_section_frame(), get_layer_enable() and get_layer_lock().
+// tests feed them with a model of the timeline instead.
+
+template<class EditT>
+using object_handle_t = decltype(std::declval<EditT&>().find_object(0, 0));
+
+template<class EditT>
+static std::vector<int> find_midpoints(EditT* edit, object_handle_t<EditT> obj)
+{
+	auto const layer_frame = edit->get_object_layer_frame(obj);
+	int const sz = std::max(edit->get_object_section_num(obj), 1);
+	std::vector<int> ret{}; ret.reserve(static_cast<size_t>(sz + 1));
+
+	ret.push_back(layer_frame.start);
+	for (int i = 1; i < sz; i++)
+		ret.push_back(edit->get_object_section_frame(obj, i));
+	ret.push_back(layer_frame.end + 1);
+	return ret;
+}
+
+template<class EditT>
+static std::tuple<object_handle_t<EditT>, int, int> find_next_obj(EditT* edit, int layer, int frame)
+{
+	if (frame > edit->info->frame_max) return { nullptr, 0, 0 };
+
+	// firstly find an object from `frame - 1` (whose end frame + 1 might be `frame`).
+	auto const obj = edit->find_object(layer, frame - 1);
+	if (obj == nullptr) return { nullptr, 0, 0 };
+
+	// if found, then it's the desired one.
+	auto const [_, st, ed] = edit->get_object_layer_frame(obj);
+	return { obj, st, ed + 1 };
+}
+
+template<class EditT>
+static std::tuple<object_handle_t<EditT>, int, int> find_prev_obj(EditT* edit, int layer, int frame)
+{
+	if (frame < 0) return { nullptr, 0, 0 };
+
+	// firstly find an object from `frame`.
+	auto const obj_r = edit->find_object(layer, frame);
+	if (obj_r != nullptr) {
+		// see if it starts before that frame.
+		auto const [_, start, end] = edit->get_object_layer_frame(obj_r);
+		if (start <= frame)
+			return { obj_r, start, end + 1 };
+	}
+
+	// secondly, search from the beginning.
+	auto const obj_l = edit->find_object(layer, 0);
+	if (obj_l == nullptr || obj_l == obj_r) return { nullptr, 0, 0 };
+	// see if it's relevant to the desired frame.
+	auto I = edit->get_object_layer_frame(obj_l);
+	std::tuple<object_handle_t<EditT>, int, int> ret = { obj_l, I.start, I.end + 1 };
+	if (I.end + 1 >= frame) return ret;
+
+	// then perform binary search.
+	// `frame_l` is the last frame of the object found so far, so an object of a single frame right after it is probed too.
+	int frame_l = I.end, frame_r = frame;
+	while (frame_l + 1 < frame_r) {
+		int frame_m = (frame_l + frame_r) >> 1;
+		auto obj_m = edit->find_object(layer, frame_m);
+		if (obj_m == obj_r) frame_r = frame_m;
+		else {
+			// obj_m must be different from both std::get<0>(ret) and obj_r.
+			I = edit->get_object_layer_frame(obj_m);
+			ret = { obj_m, I.start, I.end + 1 };
+			if (I.end + 1 >= frame) break;
+
+			frame_l = I.end;
+		}
+	}
+	return ret;
+}
+
+inline size_t find_next_midpoint(std::vector<int> const& midpoints, int frame)
+{
+	// find the least midpoint which is >= `frame`.
+	// `midpoints` is in ascending order, so find by binary search.
+	// `frame` is assumed to be contained in the range.
+	// returns the index of the found midpoint.
+	int l = -1, r = static_cast<int>(midpoints.size());
+	while (l + 1 < r) {
+		int m = (l + r) >> 1;
+		if (midpoints[m] >= frame) r = m;
+		else l = m;
+	}
+	assert(r != static_cast<int>(midpoints.size()));
+	return r;
+}
+
+inline size_t find_prev_midpoint(std::vector<int> const& midpoints, int frame)
+{
+	// find the greatest midpoint which is <= `frame`.
+	// `midpoints` is in ascending order, so find by binary search.
+	// `frame` is assumed to be contained in the range.
+	// returns the index of the found midpoint.
+	auto idx = find_next_midpoint(midpoints, frame);
+	if (midpoints[idx] > frame) idx--;
+	return idx;
+}
+
+template<class EditT>
+static int find_boundary(EditT* edit, int layer, int frame, bool forward, bool allow_midpt)
+{
+	if (forward) {
+		// search forward
+		auto const [obj, obj_start, obj_end] = find_next_obj(edit, layer, frame);
+		if (obj == nullptr) return edit->info->frame_max; // no more object
+		else if (allow_midpt && frame > obj_start) {
+			// see if there is a midpoint on the found object.
+			auto const midpoints = find_midpoints(edit, obj);
+			[[assume(midpoints.size() >= 2)]];
+			if (midpoints.size() > 2) {
+				auto const idx = find_next_midpoint(midpoints, frame);
+				return midpoints[idx];
+			}
+		}
+		return frame <= obj_start ? obj_start : obj_end;
+	}
+	else {
+		// search backward
+		auto const [obj, obj_start, obj_end] = find_prev_obj(edit, layer, frame);
+		if (obj == nullptr) return 0; // no more object
+		else if (allow_midpt && obj_end > frame) {
+			// see if there is a midpoint on the found object.
+			auto const midpoints = find_midpoints(edit, obj);
+			[[assume(midpoints.size() >= 2)]];
+			if (midpoints.size() > 2) {
+				auto const idx = find_prev_midpoint(midpoints, frame);
+				return midpoints[idx];
+			}
+		}
+		return obj_end <= frame ? obj_end : obj_start;
+	}
+}
+
+// layers to skip in scene-wide searches.
+enum class ignore_layer : uint32_t {
+	none = 0,
+	hidden = 1,
+	locked = 2,
+	hidden_or_locked = 3,
+};
+
+template<class EditT>
+static bool is_layer_ignored(EditT* edit, int layer, ignore_layer mode)
+{
+	// whether the layer should be skipped in scene-wide searches.
+	switch (mode) {
+	case ignore_layer::hidden:
+		return !edit->get_layer_enable(layer);
+	case ignore_layer::locked:
+		return edit->get_layer_lock(layer);
+	case ignore_layer::hidden_or_locked:
+		return !edit->get_layer_enable(layer) || edit->get_layer_lock(layer);
+	case ignore_layer::none: default:
+		return false;
+	}
+}
+
+template<class EditT>
+static int find_scene_boundary(EditT* edit, int frame, bool forward, bool allow_midpt, ignore_layer mode)
+{
+	// find the nearest boundary among all layers.
+	int next_frame = forward ? edit->info->frame_max : 0;
+	for (int layer = edit->info->layer_max; layer >= 0; layer--) {
+		if (is_layer_ignored(edit, layer, mode)) continue;
+
+		auto f = find_boundary(edit, layer, frame, forward, allow_midpt);
+		next_frame = (next_frame > f) == forward ? f : next_frame;
+	}
+	return next_frame;
+}
+
+// `BpmT` is BPM_INFO. `bpm_list` is sorted by `start` and not empty.
+template<class BpmT>
+static constexpr auto find_bpm_grid_at(std::vector<BpmT>& bpm_list, int frame, int rate, int scale)
+{
+	double const t = static_cast<double>(frame) * scale / rate;
+	return std::partition_point(bpm_list.begin() + 1, bpm_list.end(),
+		[T = std::max(bpm_list.front().start, t)](BpmT const& info) { return info.start <= T; }) - 1;
+}
+
+// `marks` is in ascending order.
+inline int find_neighbor_mark(std::vector<int> const& marks, int frame, bool forward, int frame_max)
+{
+	auto it = std::partition_point(marks.begin(), marks.end(),
+		[f = forward ? frame + 1 : frame](int m) { return m < f; });
+	if (forward)
+		return it == marks.end() ? frame_max : *it;
+	else
+		return it == marks.begin() ? 0 : *(it - 1);
+}
+
+// limits the rounds and the elapsed time of a search loop,
+// so a pathological timeline can't freeze the UI.
+// `ClockT::now()` returns the time in milliseconds.
+template<class ClockT>
+struct search_budget {
+	constexpr static uint64_t time_limit = 500; // in milliseconds.
+	enum class cause : uint8_t { none, rounds, time };
+
+	size_t const rounds_max;
+	uint64_t const deadline = ClockT::now() + time_limit;
+	size_t rounds = 0;
+	cause truncated = cause::none; // tells a truncated search from one finding no space.
+
+	// returns false and records the cause if the budget has run out.
+	bool step()
+	{
+		if (rounds >= rounds_max) truncated = cause::rounds;
+		else if (ClockT::now() >= deadline) truncated = cause::time;
+		else { rounds++; return true; }
+		return false;
+	}
+};
+
+// "jump-over" searches for the nearest offset where `targets` fit without overlapping others.
+// `targets` are pairs of an object and its position, `is_target(obj)` tells them from the others.
+// a collision pushes the offset just past the other object, so each pair of a target and
+// an other object collides at most once, and every round but the last has a collision.
+// the rounds are therefore bounded by jump_over_rounds().
+
+// one plus the number of (target, other object) pairs on the same layer that can collide, at most `cap`.
+template<class EditT, class TargetsT, class PredT>
+static size_t jump_over_rounds(EditT* edit, TargetsT const& targets, PredT&& is_target, bool forward, size_t cap)
+{
+	// the extent of the targets on each layer.
+	struct extent { int layer, frame; size_t count; };
+	std::vector<extent> layers{};
+	for (auto const& [_, pos] : targets) {
+		int const f = forward ? pos.start : pos.end;
+		if (auto const it = std::ranges::find(layers, pos.layer, &extent::layer); it == layers.end())
+			layers.push_back({ pos.layer, f, 1 });
+		else {
+			it->frame = forward ? std::min(it->frame, f) : std::max(it->frame, f);
+			it->count++;
+		}
+	}
+
+	// count the other objects in the direction of the search.
+	size_t ret = 1;
+	for (auto const& [layer, frame, count] : layers) {
+		for (int f = forward ? frame : 0; ret < cap; ) {
+			auto const o = edit->find_object(layer, f);
+			if (o == nullptr) break;
+			auto const p = edit->get_object_layer_frame(o);
+			if (!forward && p.start > frame) break;
+			f = p.end + 1;
+			if (!is_target(o)) ret += count;
+		}
+	}
+	return std::min(ret, cap);
+}
+
+// the offset to the left, from 2 up to `limit`, or 0 if not found or truncated.
+template<class EditT, class TargetsT, class PredT, class BudgetT>
+static int find_space_left(EditT* edit, TargetsT const& targets, PredT&& is_target, int limit, BudgetT& budget)
+{
+	for (int ofs = 2, prev = ofs; ofs <= limit; prev = ofs) {
+		if (!budget.step()) return 0;
+		for (auto const& [_, pos] : targets) {
+			for (int f = pos.start - ofs; f <= pos.end - ofs; ) {
+				auto const o = edit->find_object(pos.layer, f);
+				if (o == nullptr) break;
+				auto const p = edit->get_object_layer_frame(o);
+				f = p.end + 1;
+				if (is_target(o)) continue; // ignore target objects.
+				if (std::max(pos.start - ofs, p.start) <= std::min(pos.end - ofs, p.end)) {
+					// objects will overlap. find the next candidate.
+					ofs = pos.end + 1 - p.start;
+					break;
+				}
+			}
+		}
+		if (prev == ofs) return ofs;
+	}
+	return 0;
+}
+
+// the offset to the right, from `ofs` on, or 0 if truncated.
+template<class EditT, class TargetsT, class PredT, class BudgetT>
+static int find_space_right(EditT* edit, TargetsT const& targets, PredT&& is_target, int ofs, BudgetT& budget)
+{
+	for (int prev = ofs; ; prev = ofs) {
+		if (!budget.step()) return 0;
+		for (auto const& [_, pos] : targets) {
+			for (int f = pos.start + ofs; f <= pos.end + ofs; ) {
+				auto const o = edit->find_object(pos.layer, f);
+				if (o == nullptr) break;
+				auto const p = edit->get_object_layer_frame(o);
+				f = p.end + 1;
+				if (is_target(o)) continue; // ignore target objects.
+				if (std::max(pos.start + ofs, p.start) <= std::min(pos.end + ofs, p.end)) {
+					// objects will overlap. find the next candidate.
+					ofs = p.end + 1 - pos.start;
+					// keep searching.
+				}
+			}
+		}
+		if (prev == ofs) return ofs;
+	}
+}
@@ -15,15 +15,23 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 #include <utility>
 #include <cmath>
 #include <limits>
-#include <bit>
+#include <cstring>
+#include <type_traits>
 #include <concepts>
 #include <memory>
+#include <span>
+#include <array>
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <tuple>
+#include <queue>
 #include <string>
 #include <string_view>
+#include <charconv>
+#include <optional>
+#include <random>
 #include <ranges>
 #include <cassert>
 
@@ -31,11 +39,17 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <CommCtrl.h>
+#include <commdlg.h>
 #pragma comment(lib, "comctl32")
+#pragma comment(lib, "comdlg32")
 
 #include "plugin2.h"
 #include "config2.h"
 #include "logging.hpp"
+#include "ini_text.hpp"
+#include "cursor_history.hpp"
+#include "timeline_search.hpp"
+#include "command_trace.hpp"
 namespace logging = AviUtl2::logging;
 
 
@@ -55,6 +69,87 @@ constexpr uint32_t least_aviutl2_ver_num = 2010400;
 constinit HMODULE dll_hinst = nullptr;
 constinit EDIT_HANDLE const* edit_handle = nullptr;
 constinit CONFIG_HANDLE* config_handle = nullptr;
+
+// reads and writes a whole .ini file at once, instead of GetPrivateProfile*()
+// or WritePrivateProfile*() which re-open and re-parse the file per key.
+class ini_file : public ini_text {
+	bool utf16 = false; // the file is in UTF-16LE with BOM, otherwise in the ANSI code page.
+
+public:
+	// returns false if the file couldn't be read.
+	bool load(std::wstring const& path)
+	{
+		std::vector<char> bytes{};
+		HANDLE const h = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (h == INVALID_HANDLE_VALUE) { parse({}); return false; }
+		LARGE_INTEGER size; DWORD read = 0;
+		bool const success = ::GetFileSizeEx(h, &size) != FALSE && size.QuadPart < (1 << 24)
+			&& (bytes.resize(static_cast<size_t>(size.QuadPart)),
+				::ReadFile(h, bytes.data(), static_cast<DWORD>(bytes.size()), &read, nullptr) != FALSE)
+			&& read == bytes.size();
+		::CloseHandle(h);
+		if (!success) { parse({}); return false; }
+
+		// decode the text.
+		std::wstring text{};
+		utf16 = bytes.size() >= 2 && bytes[0] == '\xff' && bytes[1] == '\xfe';
+		if (utf16) {
+			text.resize((bytes.size() - 2) / sizeof(wchar_t));
+			std::memcpy(text.data(), bytes.data() + 2, text.size() * sizeof(wchar_t));
+		}
+		else if (!bytes.empty()) {
+			int const len = ::MultiByteToWideChar(CP_ACP, 0, bytes.data(), static_cast<int>(bytes.size()), nullptr, 0);
+			text.resize(len);
+			::MultiByteToWideChar(CP_ACP, 0, bytes.data(), static_cast<int>(bytes.size()), text.data(), len);
+		}
+		parse(text);
+		return true;
+	}
+
+	// writes to a temporary file and then replaces the old one,
+	// so a partially written file never shows up.
+	bool save(std::wstring const& path) const
+	{
+		auto const text = ini_text::text();
+
+		// encode the text.
+		std::vector<char> bytes{};
+		if (utf16) {
+			bytes.resize(2 + text.size() * sizeof(wchar_t));
+			bytes[0] = '\xff'; bytes[1] = '\xfe';
+			std::memcpy(bytes.data() + 2, text.data(), text.size() * sizeof(wchar_t));
+		}
+		else if (!text.empty()) {
+			int const len = ::WideCharToMultiByte(CP_ACP, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+			bytes.resize(len);
+			::WideCharToMultiByte(CP_ACP, 0, text.data(), static_cast<int>(text.size()), bytes.data(), len, nullptr, nullptr);
+		}
+
+		auto const tmp_path = path + L".tmp";
+		bool success = false;
+		if (HANDLE const h = ::CreateFileW(tmp_path.c_str(), GENERIC_WRITE, 0, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr); h != INVALID_HANDLE_VALUE) {
+			DWORD written = 0;
+			success = ::WriteFile(h, bytes.data(), static_cast<DWORD>(bytes.size()), &written, nullptr) != FALSE
+				&& written == bytes.size();
+			::CloseHandle(h);
+		}
+		if (success)
+			success = ::MoveFileExW(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+		else ::DeleteFileW(tmp_path.c_str());
+		return success;
+	}
+
+	// last modified time of the file, or 0 if it doesn't exist.
+	static uint64_t last_write_time(std::wstring const& path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (::GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) == FALSE) return 0;
+		return (uint64_t{ data.ftLastWriteTime.dwHighDateTime } << 32) | data.ftLastWriteTime.dwLowDateTime;
+	}
+};
+
 constinit struct Settings {
 #define decl_prop(type, name, def)	\
 	type name = name##_def; \
@@ -64,12 +159,7 @@ constinit struct Settings {
 	decl_prop(type, name, def); \
 	constexpr static type name##_min = (min), name##_max = (max)
 
-	enum class ignore_layer : uint32_t {
-		none = 0,
-		hidden = 1,
-		locked = 2,
-		hidden_or_locked = 3,
-	};
+	using ignore_layer = ::ignore_layer;
 	struct {
 		decl_prop_minmax(double, page_rate, 0.25, 0.01, 1.0);
 		decl_prop_minmax(int, bpm_grid_div, 4, 1, 16);
@@ -101,44 +191,56 @@ constinit struct Settings {
 	struct {
 		decl_prop_minmax(int, queue_size, 1 << 8, 1 << 4, 1 << 14);
 		decl_prop_minmax(double, polling_cooltime, 0.5, 0.0, 10.0);
+		decl_prop_minmax(int, memory_budget, 1 << 10, 1 << 6, 1 << 20); // in KiB.
 
 		constexpr static std::wstring_view section = L"cursor_undo";
 	} cursor_undo;
 
+	struct {
+		decl_prop(bool, enabled, false);
+
+		constexpr static std::wstring_view section = L"trace";
+	} trace;
+
+	struct {
+		decl_prop_minmax(int, tolerance, 2, 1, 30); // in frames.
+
+		constexpr static std::wstring_view section = L"audit";
+	} audit;
+
 #undef decl_prop_minmax
 #undef decl_prop
 
-private:
-	std::wstring ini_path() const
+	// path to a file next to this plugin, with the extension replaced.
+	static std::wstring plugin_file_path(std::wstring_view const& ext)
 	{
 		wchar_t buf[MAX_PATH];
 		::GetModuleFileNameW(dll_hinst, buf, std::size(buf));
 		std::wstring path{ buf };
 		auto pos = path.rfind(L'.');
 		if (pos != path.npos) {
-			path = path.substr(0, pos) + L".ini";
+			path = path.substr(0, pos) + std::wstring{ ext };
 		}
 		else {
-			path += L".ini";
+			path += ext;
 		}
 		return path;
 	}
-	template<size_t N>
-	std::wstring read_ini_string(std::wstring_view const& section, std::wstring_view const& key, std::wstring_view const& default_value, std::wstring const& path) const
+
+private:
+	// modified time of the .ini file when it was last read or written.
+	mutable uint64_t ini_write_time = 0;
+
+	std::wstring ini_path() const
 	{
-		wchar_t buf[N];
-		auto len = ::GetPrivateProfileStringW(
-			section.data(), key.data(), default_value.data(),
-			buf, static_cast<DWORD>(std::size(buf)),
-			path.data());
-		return std::wstring{ buf, len };
+		return plugin_file_path(L".ini");
 	}
 	template<size_t N>
-	void write_ini_value(std::wstring_view const& section, std::wstring_view const& key, auto val, wchar_t const* fmt, std::wstring const& path) const
+	static std::wstring format_ini_value(auto val, wchar_t const* fmt)
 	{
 		wchar_t buf[N];
 		::swprintf_s(buf, fmt, val);
-		::WritePrivateProfileStringW(section.data(), key.data(), buf, path.c_str());
+		return buf;
 	}
 
 public:
@@ -146,20 +248,23 @@ public:
 	{
 		// load from ini file.
 		auto path = ini_path();
+		ini_file ini{};
+		ini.load(path);
+		ini_write_time = ini_file::last_write_time(path);
 	#define read_double(sec, key) \
 		do { \
-			auto raw = read_ini_string<32>(sec.section, sec.key##_key, L"", path); \
+			std::wstring const raw{ ini.get(sec.section, sec.key##_key).value_or(L"") }; \
 			wchar_t* e; double v; \
 			sec.key = raw.size() > 0 && (v = std::wcstod(raw.c_str(), &e), *e == L'\0') ? v : sec.key##_def; \
 			sec.key = std::clamp(sec.key, sec.key##_min, sec.key##_max); \
 		} while (false)
 	#define read_int(sec, key) \
 		do { \
-			sec.key = ::GetPrivateProfileIntW(sec.section.data(), sec.key##_key.data(), sec.key##_def, path.c_str()); \
+			sec.key = ini.get_int(sec.section, sec.key##_key, sec.key##_def); \
 			sec.key = std::clamp(sec.key, sec.key##_min, sec.key##_max); \
 		} while (false)
-	#define read_bool(sec, key) sec.key = ::GetPrivateProfileIntW(sec.section.data(), sec.key##_key.data(), sec.key##_def ? 1 : 0, path.c_str()) != 0
-	#define read_type(sec, key, type) sec.key = static_cast<type>(::GetPrivateProfileIntW(sec.section.data(), sec.key##_key.data(), static_cast<int>(sec.key##_def), path.c_str()))
+	#define read_bool(sec, key) sec.key = ini.get_int(sec.section, sec.key##_key, sec.key##_def ? 1 : 0) != 0
+	#define read_type(sec, key, type) sec.key = static_cast<type>(ini.get_int(sec.section, sec.key##_key, static_cast<int>(sec.key##_def)))
 
 		read_double	(search, page_rate);
 		read_int	(search, bpm_grid_div);
@@ -184,6 +289,11 @@ public:
 
 		read_int	(cursor_undo, queue_size);
 		read_double	(cursor_undo, polling_cooltime);
+		read_int	(cursor_undo, memory_budget);
+
+		read_bool	(trace, enabled);
+
+		read_int	(audit, tolerance);
 
 	#undef read_type
 	#undef read_bool
@@ -196,9 +306,11 @@ public:
 
 	void save() const
 	{
-		// save to ini file.
+		// save to ini file, keeping the other contents of the file.
 		auto path = ini_path();
-	#define write_val(sec, key, proj, fmt) write_ini_value<16>(sec.section, sec.key##_key, proj(sec.key), fmt, path)
+		ini_file ini{};
+		ini.load(path);
+	#define write_val(sec, key, proj, fmt) ini.set(sec.section, sec.key##_key, format_ini_value<16>(proj(sec.key), fmt))
 	#define write_int(sec, key) write_val(sec, key, , L"%d")
 	#define write_bool(sec, key) write_val(sec, key, [](auto x) { return x ? 1 : 0; } , L"%d")
 
@@ -218,131 +330,57 @@ public:
 		// so missing .ini file will be fully generated.
 		write_int	(cursor_undo, queue_size);
 		write_val	(cursor_undo, polling_cooltime, , L"%.3f");
+		write_int	(cursor_undo, memory_budget);
+
+		write_bool	(trace, enabled);
+
+		write_int	(audit, tolerance);
 
 	#undef write_bool
 	#undef write_int
 	#undef write_val
 
+		if (!ini.save(path)) {
+			logging::warn(L"Failed to save the settings.");
+			return;
+		}
+		ini_write_time = ini_file::last_write_time(path);
+
 		// logging.
 		logging::verbose(L"Settings saved.");
 	}
-} settings{};
 
-template<class T>
-struct undo_history {
-	size_t size() const { return n; }
-	size_t max_size() const { return N; }
-	void forward(T v)
-	{
-		n++;
-		if (n > N) {
-			i0 = (i0 + n) % N;
-			n = N;
-		}
-		size_t i = (i0 + n - 1) % N;
-		vals[i] = v;
-		m = n;
-	}
-	bool check_forward(T v)
-	{
-		if (v == peek()) return false;
-		forward(v);
-		return true;
-	}
-	bool repush(T& v)
+	// whether the .ini file has been modified by others since it was last read or written.
+	bool is_modified_outside() const
 	{
-		if (m <= n) return false;
-		n++;
-		size_t i = (i0 + n - 1) % N;
-		v = vals[i];
-		return true;
-	}
-	T peek() const
-	{
-		if (n == 0) return T{};
-		size_t i = (i0 + n - 1) % N;
-		return vals[i];
-	}
-	T backward()
-	{
-		if (n == 0) return T{};
-		else if (n > 1) n--;
-		size_t i = (i0 + n - 1) % N;
-		return vals[i];
-	}
-	void clear(T v)
-	{
-		i0 = n = m = 0;
-		forward(v);
-	}
-	constexpr undo_history(size_t N) : N{ N }, i0{ 0 }, n{ 0 }, m{ 0 }
-	{
-		vals = std::make_unique_for_overwrite<int[]>(N);
+		auto const t = ini_file::last_write_time(ini_path());
+		return t != 0 && t != ini_write_time;
 	}
-private:
-	size_t i0, n, m, N;
-	std::unique_ptr<T[]> vals;
-};
-template<class KeyT, class ValT>
-struct undo_bundle {
-private:
-	size_t max_len;
-	std::map<KeyT, undo_history<ValT>> queues{};
-	undo_history<ValT>* curr = nullptr;
+} settings{};
 
-public:
-	void set_key(KeyT const& key, ValT const& init)
-	{
-		auto p = queues.try_emplace(key, max_len);
-		if (p.second) p.first->second.clear(init);
-		curr = &p.first->second;
-	}
-	void clear()
-	{
-		queues.clear();
-		curr = nullptr;
-	}
-	undo_history<ValT>* current() const { return curr; }
-	undo_bundle(size_t max_len) : max_len{ max_len }, queues{} {}
+struct tick_count_clock {
+	static uint64_t now() { return ::GetTickCount64(); }
 };
+using cursor_undo_bundle = cooltime_undo_bundle<int, cursor_state, tick_count_clock>;
+cursor_undo_bundle cursor_undo_queues{ 0, 0 };
 
-template<class KeyT, class ValT>
-struct cooltime_undo_bundle : undo_bundle<KeyT, ValT> {
-private:
-	uint64_t last_poll_time = 0;
-
-public:
-	bool is_cooltime(uint64_t curr_time) const
-	{
-		if (last_poll_time > 0 && (curr_time - last_poll_time) * 0.001 < settings.cursor_undo.polling_cooltime)
-			return true;
-		return false;
-	}
-	void set_cooltime(uint64_t curr_time)
-	{
-		last_poll_time = curr_time;
-	}
-	static uint64_t get_curr_polltime()
-	{
-		return ::GetTickCount64();
-	}
-
-	bool check_cooltime()
-	{
-		if (auto const t = get_curr_polltime();
-			is_cooltime(t)) return true;
-		else set_cooltime(t);
-		return false;
-	}
-	void reset_cooltime()
-	{
-		set_cooltime(0);
-	}
+// named cursor bookmarks of a scene, as registers 'a' through 'z'.
+struct cursor_bookmarks {
+	constexpr static size_t count = 26;
+	std::array<cursor_state, count> regs;
+	uint32_t valid_bits; // bit i is set if regs[i] holds a position.
 
-	cooltime_undo_bundle(size_t max_len) : undo_bundle<KeyT, ValT>{ max_len } {};
+	constexpr bool has(size_t i) const { return ((valid_bits >> i) & 1) != 0; }
 };
+std::unordered_map<int, cursor_bookmarks> cursor_bookmark_table{};
 
-cooltime_undo_bundle<int, int> cursor_undo_queues{ 0 };
+// position of the focused object, to avoid read sections on focus changes.
+constinit struct {
+	OBJECT_HANDLE obj = nullptr;
+	OBJECT_LAYER_FRAME pos{};
+	bool valid = false; // cleared whenever objects are updated.
+	bool expected = false; // the next focus change is the one made by this plugin.
+} focus_cache{};
 
 template<class CharT>
 struct string_pool {
@@ -397,6 +435,37 @@ static void remove_messages(HWND hwnd, UINT msg_from, UINT msg_until)
 }
 static void remove_messages(HWND hwnd, UINT message) { remove_messages(hwnd, message, message); }
 
+// read-only view of a file mapped into memory.
+struct mapped_file {
+	std::span<std::byte const> data{};
+
+	mapped_file(std::wstring const& path)
+	{
+		file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return;
+		LARGE_INTEGER size;
+		if (::GetFileSizeEx(file, &size) == FALSE || size.QuadPart <= 0) return;
+		mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) return;
+		view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr) return;
+		data = { static_cast<std::byte const*>(view), static_cast<size_t>(size.QuadPart) };
+	}
+	~mapped_file()
+	{
+		if (view != nullptr) ::UnmapViewOfFile(view);
+		if (mapping != nullptr) ::CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) ::CloseHandle(file);
+	}
+	mapped_file(mapped_file const&) = delete;
+	mapped_file& operator=(mapped_file const&) = delete;
+
+private:
+	HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+	void const* view = nullptr;
+};
+
 static EDIT_INFO get_edit_info()
 {
 	EDIT_INFO info;
@@ -411,12 +480,6 @@ static std::vector<BPM_INFO> get_bpm_info(EDIT_SECTION* edit)
 	edit->get_grid_bpm_list(ret.data(), static_cast<int>(ret.size()), sizeof(BPM_INFO));
 	return ret;
 }
-static constexpr auto find_bpm_grid_at(std::vector<BPM_INFO>& bpm_list, int frame, int rate, int scale)
-{
-	double const t = static_cast<double>(frame) * scale / rate;
-	return std::partition_point(bpm_list.begin() + 1, bpm_list.end(),
-		[T = std::max(bpm_list.front().start, t)](BPM_INFO const& info) { return info.start <= T; }) - 1;
-}
 
 static std::vector<int> collect_mark_points(EDIT_SECTION* edit)
 {
@@ -471,12 +534,41 @@ static std::tuple<int, int, bool> calc_scroll_pos(EDIT_INFO const& curr_info, OB
 		frame != curr_info.display_frame_start };
 }
 
+static void change_focus_object(EDIT_SECTION* edit, OBJECT_HANDLE obj)
+{
+	// sets the focus and remembers the position of the object,
+	// so the following CHANGE_FOCUS_OBJECT event doesn't need to look it up.
+	if (obj == edit->get_focus_object()) return; // no event would be raised.
+	edit->set_focus_object(obj);
+	focus_cache = {
+		.obj = obj,
+		.pos = obj != nullptr ? edit->get_object_layer_frame(obj) : OBJECT_LAYER_FRAME{},
+		.valid = true,
+		.expected = true,
+	};
+}
+
 ////////////////////////////////
 // window message handler.
 ////////////////////////////////
 constinit struct PluginWindow {
 	HWND root = nullptr;
 
+	// kinds of deferred tasks. a newer request replaces the pending one of the same kind.
+	struct deferred {
+		enum kind : uint32_t {
+			restore_key_state,
+			follow_focus,
+			prefetch,
+			flush_log,
+			analyze_audio,
+			export_edit_points,
+			import_marks,
+
+			count_kinds,
+		};
+	};
+
 private:
 	static constexpr std::wstring_view
 		class_name = L"TLWalkaround2Client";
@@ -508,6 +600,36 @@ private:
 			request_callback = WM_USER + 64,
 		};
 	};
+
+	// preallocated slots for deferred tasks, one per kind.
+	// all requests come from the UI thread, so no synchronization is needed.
+	struct deferred_task {
+		void (*invoke)(void(*)(), void const*) = nullptr;
+		void (*callback)() = nullptr;
+		alignas(8) std::byte payload[16]{};
+		uint32_t seq = 0; // 0 if not pending.
+	} tasks[deferred::count_kinds]{};
+	uint32_t task_seq = 0;
+	bool wake_posted = false;
+
+	void drain_tasks()
+	{
+		wake_posted = false;
+
+		// take the pending tasks out first, as they may post further tasks.
+		deferred_task pending[deferred::count_kinds];
+		size_t n = 0;
+		for (auto& task : tasks) {
+			if (task.seq == 0) continue;
+			pending[n++] = task;
+			task.seq = 0;
+		}
+
+		// run them in the requested order.
+		std::sort(pending, pending + n, [](auto const& l, auto const& r) { return l.seq < r.seq; });
+		for (auto const& task : std::span{ pending, n })
+			task.invoke(task.callback, task.payload);
+	}
 	struct {
 		struct {
 			HWND label = nullptr;
@@ -784,29 +906,18 @@ private:
 			ctrl.page_rate.slider_resolution));
 		::SendMessageW(ctrl.page_rate.slider, TBM_SETTICFREQ,
 			ctrl.page_rate.slider_resolution / ctrl.page_rate.slider_tick_count, 0);
-		::SendMessageW(ctrl.page_rate.slider, TBM_SETPOS, TRUE,
-			std::lround(settings.search.page_rate * ctrl.page_rate.slider_resolution));
 
 		// set spin properties.
 		::SendMessageW(ctrl.bpm_div.spin, UDM_SETRANGE32, settings.search.bpm_grid_div_min, settings.search.bpm_grid_div_max);
-		::SendMessageW(ctrl.bpm_div.spin, UDM_SETPOS32, 0, settings.search.bpm_grid_div);
-
-		// set checkbox state.
-		::SendMessageW(ctrl.suppress_shift.check, BM_SETCHECK, settings.search.suppress_shift ? BST_CHECKED : BST_UNCHECKED, 0);
-		::SendMessageW(ctrl.focus_follows.check, BM_SETCHECK, settings.search.focus_follows ? BST_CHECKED : BST_UNCHECKED, 0);
-		::SendMessageW(ctrl.navigation.layer_focus_check, BM_SETCHECK, settings.navigation.layer_follows_focus ? BST_CHECKED : BST_UNCHECKED, 0);
-		::SendMessageW(ctrl.navigation.scroll_focus_check, BM_SETCHECK, settings.navigation.scroll_follows_focus ? BST_CHECKED : BST_UNCHECKED, 0);
 
-		// set combo box items and selection.
+		// set combo box items.
 		::SendMessageW(ctrl.ignore_layers.combo, CB_ADDSTRING, {}, reinterpret_cast<LPARAM>(translate(L"なし")));
 		::SendMessageW(ctrl.ignore_layers.combo, CB_ADDSTRING, {}, reinterpret_cast<LPARAM>(translate(L"非表示")));
 		::SendMessageW(ctrl.ignore_layers.combo, CB_ADDSTRING, {}, reinterpret_cast<LPARAM>(translate(L"ロック")));
 		::SendMessageW(ctrl.ignore_layers.combo, CB_ADDSTRING, {}, reinterpret_cast<LPARAM>(translate(L"非表示とロック")));
-		::SendMessageW(ctrl.ignore_layers.combo, CB_SETCURSEL, static_cast<WPARAM>(settings.search.ignore_layers), 0);
 
 		::SendMessageW(ctrl.stretch.combo, CB_ADDSTRING, {}, reinterpret_cast<LPARAM>(translate(L"秒")));
 		::SendMessageW(ctrl.stretch.combo, CB_ADDSTRING, {}, reinterpret_cast<LPARAM>(translate(L"フレーム")));
-		::SendMessageW(ctrl.stretch.combo, CB_SETCURSEL, static_cast<WPARAM>(settings.stretch.unit), 0);
 
 		// set fonts.
 		for (HWND control : {
@@ -843,11 +954,43 @@ private:
 		ctrl.layout(root);
 
 		// first sync.
+		load_control_values();
+
+		// logging.
+		logging::verbose(L"Created controls on the client window.");
+	}
+
+	// sets the state of the controls to the current setting values.
+	void load_control_values() const
+	{
+		::SendMessageW(ctrl.page_rate.slider, TBM_SETPOS, TRUE,
+			std::lround(settings.search.page_rate * ctrl.page_rate.slider_resolution));
+		::SendMessageW(ctrl.bpm_div.spin, UDM_SETPOS32, 0, settings.search.bpm_grid_div);
+
+		::SendMessageW(ctrl.suppress_shift.check, BM_SETCHECK, settings.search.suppress_shift ? BST_CHECKED : BST_UNCHECKED, 0);
+		::SendMessageW(ctrl.focus_follows.check, BM_SETCHECK, settings.search.focus_follows ? BST_CHECKED : BST_UNCHECKED, 0);
+		::SendMessageW(ctrl.navigation.layer_focus_check, BM_SETCHECK, settings.navigation.layer_follows_focus ? BST_CHECKED : BST_UNCHECKED, 0);
+		::SendMessageW(ctrl.navigation.scroll_focus_check, BM_SETCHECK, settings.navigation.scroll_follows_focus ? BST_CHECKED : BST_UNCHECKED, 0);
+
+		::SendMessageW(ctrl.ignore_layers.combo, CB_SETCURSEL, static_cast<WPARAM>(settings.search.ignore_layers), 0);
+
 		sync_page_rate(true);
 		sync_stretch_time(false, true);
+	}
+
+	// polls the .ini file and reloads the settings if it was edited outside.
+	constexpr static UINT_PTR settings_watch_timer_id = 2; // 1 and 3 are used by cursor_undo and tap_tempo.
+	constexpr static UINT settings_watch_interval = 1000; // in milliseconds.
+	void check_settings_file() const
+	{
+		if (!settings.is_modified_outside()) return;
+
+		settings.load();
+		cursor_undo_queues.polling_cooltime = settings.cursor_undo.polling_cooltime;
+		if (ctrl.initialized()) load_control_values();
 
 		// logging.
-		logging::verbose(L"Created controls on the client window.");
+		logging::info(L"Settings reloaded from the modified file.");
 	}
 
 public:
@@ -876,14 +1019,28 @@ public:
 		logging::verbose(L"Created the client window.");
 		return true;
 	}
-	template<class ParamT> requires(sizeof(ParamT) == sizeof(uintptr_t))
-	void post_callback(void(*callback)(ParamT), ParamT param) const
+	template<class ParamT>
+		requires(std::is_trivially_copyable_v<ParamT> && sizeof(ParamT) <= sizeof(deferred_task::payload))
+	void post_callback(deferred::kind kind, void(*callback)(ParamT), ParamT const& param)
 	{
-		post_callback(reinterpret_cast<void(*)(uintptr_t)>(callback), std::bit_cast<uintptr_t>(param));
-	}
-	void post_callback(void(*callback)(uintptr_t), uintptr_t param) const
-	{
-		::PostMessageW(root, prv_mes::request_callback, param, reinterpret_cast<LPARAM>(callback));
+		auto& task = tasks[kind];
+		task.invoke = [](void(*callback)(), void const* payload) static
+		{
+			ParamT param;
+			std::memcpy(&param, payload, sizeof(param));
+			reinterpret_cast<void(*)(ParamT)>(callback)(param);
+		};
+		task.callback = reinterpret_cast<void(*)()>(callback);
+		std::memcpy(task.payload, &param, sizeof(param));
+		if (++task_seq == 0) task_seq = 1; // 0 is reserved for idle slots.
+		task.seq = task_seq;
+
+		// a single wake-up message drains all the pending tasks.
+		// if posting fails, the task stays pending and the next request tries again.
+		if (!wake_posted) {
+			wake_posted = root != nullptr && ::PostMessageW(root, prv_mes::request_callback, 0, 0) != FALSE;
+			if (!wake_posted) logging::warn(L"Failed to post a deferred task.");
+		}
 	}
 	void destroy() const
 	{
@@ -1164,8 +1321,17 @@ private:
 		case WM_CREATE:
 		{
 			root = hwnd;
+			::SetTimer(hwnd, settings_watch_timer_id, settings_watch_interval, nullptr);
 			return 0;
 		}
+		case WM_TIMER:
+		{
+			if (wparam == settings_watch_timer_id) {
+				check_settings_file();
+				return 0;
+			}
+			break;
+		}
 		case WM_NCDESTROY:
 		{
 			// delete the font.
@@ -1175,8 +1341,13 @@ private:
 			}
 
 			// save the setting on terminating.
+			::KillTimer(hwnd, settings_watch_timer_id);
 			settings.save();
 
+			// no more deferred flushes.
+			logging::buffer::request_flush = nullptr;
+			logging::flush();
+
 			// disable this object.
 			root = nullptr;
 			break;
@@ -1319,9 +1490,8 @@ private:
 		// private messages.
 		case prv_mes::request_callback:
 		{
-			// call the requested function.
-			auto const callback = reinterpret_cast<void(*)(uintptr_t)>(lparam);
-			if (callback != nullptr) callback(wparam);
+			// call the requested functions.
+			drain_tasks();
 			return 0;
 		}
 		case WM_KEYDOWN:
@@ -1346,130 +1516,231 @@ private:
 ////////////////////////////////
 // timeline searching functions.
 ////////////////////////////////
-static std::vector<int> find_midpoints(EDIT_SECTION* edit, OBJECT_HANDLE obj)
+// the searches themselves are in timeline_search.hpp.
+static bool is_layer_ignored(EDIT_SECTION* edit, int layer)
 {
-	auto const layer_frame = edit->get_object_layer_frame(obj);
-	int const sz = std::max(edit->get_object_section_num(obj), 1);
-	std::vector<int> ret{}; ret.reserve(static_cast<size_t>(sz + 1));
+	return is_layer_ignored(edit, layer, settings.search.ignore_layers);
+}
 
-	ret.push_back(layer_frame.start);
-	for (int i = 1; i < sz; i++)
-		ret.push_back(edit->get_object_section_frame(obj, i));
-	ret.push_back(layer_frame.end + 1);
-	return ret;
+static int find_scene_boundary(EDIT_SECTION* edit, int frame, bool forward, bool allow_midpt)
+{
+	return find_scene_boundary(edit, frame, forward, allow_midpt, settings.search.ignore_layers);
 }
 
-static std::tuple<OBJECT_HANDLE, int, int> find_next_obj(EDIT_SECTION* edit, int layer, int frame)
+
+////////////////////////////////
+// boundary prefetching.
+////////////////////////////////
+namespace boundary_prefetch
 {
-	if (frame > edit->info->frame_max) return { nullptr, 0, 0 };
+	// number of boundaries to compute ahead in each direction.
+	constexpr size_t prefetch_count = 8;
 
-	// firstly find an object from `frame - 1` (whose end frame + 1 might be `frame`).
-	auto const obj = edit->find_object(layer, frame - 1);
-	if (obj == nullptr) return { nullptr, 0, 0 };
+	struct query {
+		int scene_id;
+		int layer; // negative for the entire scene.
+		bool allow_midpt;
+		Settings::ignore_layer ignore_layers;
 
-	// if found, then it's the desired one.
-	auto const [_, st, ed] = edit->get_object_layer_frame(obj);
-	return { obj, st, ed + 1 };
-}
+		bool operator==(query const&) const = default;
+	};
 
-static std::tuple<OBJECT_HANDLE, int, int> find_prev_obj(EDIT_SECTION* edit, int layer, int frame)
-{
-	if (frame < 0) return { nullptr, 0, 0 };
+	constinit struct {
+		// bumped whenever the timeline might have changed.
+		uint64_t version = 1;
+
+		query key{ .scene_id = -1 };
+		uint64_t key_version = 0;
+		// chains of boundaries starting from the origin frame, indexed by direction.
+		// each element is the destination when the command is invoked at the previous element.
+		std::vector<int> chains[2]{};
+		// layers skipped in scene-wide searches at the time of prefetching.
+		std::vector<bool> ignored{};
+
+		uint32_t hits = 0, lookups = 0;
+	} cache{};
+
+	static std::vector<bool> collect_ignored_layers(EDIT_SECTION* edit)
+	{
+		if (settings.search.ignore_layers == Settings::ignore_layer::none) return {};
+		std::vector<bool> ret(static_cast<size_t>(edit->info->layer_max + 1));
+		for (int layer = 0; layer <= edit->info->layer_max; layer++)
+			ret[layer] = is_layer_ignored(edit, layer);
+		return ret;
+	}
 
-	// firstly find an object from `frame`.
-	auto const obj_r = edit->find_object(layer, frame);
-	if (obj_r != nullptr) {
-		// see if it starts before that frame.
-		auto const [_, start, end] = edit->get_object_layer_frame(obj_r);
-		if (start <= frame)
-			return { obj_r, start, end + 1 };
+	// whether the layer states still match the ones the chains were made with.
+	// the host doesn't notify of hiding or locking layers, so this is checked before each use.
+	static bool ignored_layers_match(EDIT_SECTION* edit)
+	{
+		if (settings.search.ignore_layers == Settings::ignore_layer::none) return cache.ignored.empty();
+		if (cache.ignored.size() != static_cast<size_t>(edit->info->layer_max + 1)) return false;
+		for (int layer = 0; layer <= edit->info->layer_max; layer++)
+			if (is_layer_ignored(edit, layer) != cache.ignored[layer]) return false;
+		return true;
 	}
 
-	// secondly, search from the beginning.
-	auto const obj_l = edit->find_object(layer, 0);
-	if (obj_l == nullptr || obj_l == obj_r) return { nullptr, 0, 0 };
-	// see if it's relevant to the desired frame.
-	auto I = edit->get_object_layer_frame(obj_l);
-	std::tuple<OBJECT_HANDLE, int, int> ret = { obj_l, I.start, I.end + 1 };
-	if (I.end + 1 >= frame) return ret;
+	static int step(EDIT_SECTION* edit, query const& key, int frame, bool forward)
+	{
+		frame += forward ? +1 : -1;
+		return key.layer >= 0 ?
+			find_boundary(edit, key.layer, frame, forward, key.allow_midpt) :
+			find_scene_boundary(edit, frame, forward, key.allow_midpt);
+	}
 
-	// then perform binary search.
-	int frame_l = std::get<2>(ret), frame_r = frame;
-	while (frame_l + 1 < frame_r) {
-		int frame_m = (frame_l + frame_r) >> 1;
-		auto obj_m = edit->find_object(layer, frame_m);
-		if (obj_m == obj_r) frame_r = frame_m;
-		else {
-			// obj_m must be different from both std::get<0>(ret) and obj_r.
-			I = edit->get_object_layer_frame(obj_m);
-			ret = { obj_m, I.start, I.end + 1 };
-			if (I.end + 1 >= frame) break;
+	static void invalidate()
+	{
+		cache.version++;
+	}
 
-			frame_l = std::get<2>(ret);
+	static query make_query(EDIT_SECTION* edit, int layer, bool allow_midpt)
+	{
+		return {
+			.scene_id = edit->info->scene_id,
+			.layer = layer,
+			.allow_midpt = allow_midpt,
+			.ignore_layers = layer < 0 ? settings.search.ignore_layers : Settings::ignore_layer::none,
+		};
+	}
+
+	// returns the index of `frame` in the chain, or negative if the chain is unusable.
+	static int find_in_chain(query const& key, int frame, bool forward)
+	{
+		if (cache.key_version != cache.version || cache.key != key) return -1;
+		auto const& chain = cache.chains[forward ? 1 : 0];
+		auto const it = std::find(chain.begin(), chain.end(), frame);
+		if (it == chain.end()) return -1;
+		return static_cast<int>(it - chain.begin());
+	}
+
+	static void prefetch(EDIT_SECTION* edit, query const& key, int origin)
+	{
+		for (bool forward : { false, true }) {
+			auto& chain = cache.chains[forward ? 1 : 0];
+			chain.clear(); chain.reserve(prefetch_count + 1);
+			chain.push_back(origin);
+			for (size_t i = 0; i < prefetch_count; i++) {
+				int const f = step(edit, key, chain.back(), forward);
+				if (f == chain.back()) break; // reached the end.
+				chain.push_back(f);
+			}
 		}
+		cache.ignored = key.layer < 0 ? collect_ignored_layers(edit) : std::vector<bool>{};
+		cache.key = key;
+		cache.key_version = cache.version;
 	}
-	return ret;
-}
 
-static size_t find_next_midpoint(std::vector<int> const& midpoints, int frame)
-{
-	// find the least midpoint which is >= `frame`.
-	// `midpoints` is in ascending order, so find by binary search.
-	// `frame` is assumed to be contained in the range.
-	// returns the index of the found midpoint.
-	int l = -1, r = static_cast<int>(midpoints.size());
-	while (l + 1 < r) {
-		int m = (l + r) >> 1;
-		if (midpoints[m] >= frame) r = m;
-		else l = m;
+	// re-computes the chains unless they still cover the current frame well ahead.
+	static void refresh(EDIT_SECTION* edit, query const& key, int frame)
+	{
+		if (key.layer < 0 && !ignored_layers_match(edit)) invalidate();
+		if (std::ranges::all_of(std::array{ false, true }, [&](bool forward) {
+			int const idx = find_in_chain(key, frame, forward);
+			return idx >= 0 && static_cast<size_t>(idx) + 1 + prefetch_count / 2 < cache.chains[forward ? 1 : 0].size();
+		})) return;
+		prefetch(edit, key, frame);
+
+		// logging.
+		logging::verbose(L"Boundary cache refilled (%u/%u hits).", cache.hits, cache.lookups);
 	}
-	assert(r != static_cast<int>(midpoints.size()));
-	return r;
-}
 
-static size_t find_prev_midpoint(std::vector<int> const& midpoints, int frame)
-{
-	// find the greatest midpoint which is <= `frame`.
-	// `midpoints` is in ascending order, so find by binary search.
-	// `frame` is assumed to be contained in the range.
-	// returns the index of the found midpoint.
-	auto idx = find_next_midpoint(midpoints, frame);
-	if (midpoints[idx] > frame) idx--;
-	return idx;
-}
+	static void request_prefetch(query const& key)
+	{
+		// compute in a later read section, so the current command returns immediately.
+		plugin_window.post_callback(PluginWindow::deferred::prefetch, +[](query key) static
+		{
+			edit_handle->call_read_section_param(&key, [](void* param, EDIT_SECTION* edit) static
+			{
+				auto const& key = *static_cast<query const*>(param);
+				if (key.scene_id != edit->info->scene_id) return; // scene has changed meanwhile.
+				refresh(edit, key, edit->info->frame);
+			});
+		}, key);
+	}
 
-static int find_boundary(EDIT_SECTION* edit, int layer, int frame, bool forward, bool allow_midpt)
-{
-	if (forward) {
-		// search forward
-		auto const [obj, obj_start, obj_end] = find_next_obj(edit, layer, frame);
-		if (obj == nullptr) return edit->info->frame_max; // no more object
-		else if (allow_midpt && frame > obj_start) {
-			// see if there is a midpoint on the found object.
-			auto const midpoints = find_midpoints(edit, obj);
-			[[assume(midpoints.size() >= 2)]];
-			if (midpoints.size() > 2) {
-				auto const idx = find_next_midpoint(midpoints, frame);
-				return midpoints[idx];
+	// finds the next boundary, answering from the prefetched chain if possible.
+	static int find_next(EDIT_SECTION* edit, query const& key, bool forward)
+	{
+		int const frame = edit->info->frame;
+		int idx = find_in_chain(key, frame, forward);
+		if (idx >= 0 && key.layer < 0 && !ignored_layers_match(edit)) {
+			invalidate(); // layer states have changed.
+			idx = -1;
+		}
+		auto const& chain = cache.chains[forward ? 1 : 0];
+		bool const hit = idx >= 0 && static_cast<size_t>(idx) + 1 < chain.size();
+		int next_frame = hit ? chain[idx + 1] : step(edit, key, frame, forward);
+		cache.lookups++;
+		if (hit) cache.hits++;
+
+	#if _DEBUG
+		// verify the cached answer against the direct search.
+		if (hit) {
+			if (int const direct = step(edit, key, frame, forward); direct != next_frame) {
+				logging::warn(L"Boundary cache mismatch at frame %d: cached %d, direct %d.", frame, next_frame, direct);
+				invalidate();
+				next_frame = direct;
 			}
 		}
-		return frame <= obj_start ? obj_start : obj_end;
+	#endif
+
+		// prepare further points later, off this command.
+		request_prefetch(key);
+
+		return next_frame;
 	}
-	else {
-		// search backward
-		auto const [obj, obj_start, obj_end] = find_prev_obj(edit, layer, frame);
-		if (obj == nullptr) return 0; // no more object
-		else if (allow_midpt && obj_end > frame) {
-			// see if there is a midpoint on the found object.
-			auto const midpoints = find_midpoints(edit, obj);
-			[[assume(midpoints.size() >= 2)]];
-			if (midpoints.size() > 2) {
-				auto const idx = find_prev_midpoint(midpoints, frame);
-				return midpoints[idx];
+
+#if _DEBUG
+	// compares the cached answers with the direct search along a random walk,
+	// refilling the chains the same way as the deferred prefetch does.
+	// the seed is fixed so a failure can be reproduced on the same timeline.
+	static void self_test(EDIT_SECTION* edit)
+	{
+		constexpr uint32_t seed = 20260401;
+		constexpr int move_count = 2000;
+		std::mt19937 rng{ seed };
+		auto const random = [&](int n) { return static_cast<int>(rng() % static_cast<uint32_t>(n)); };
+
+		invalidate();
+		int frame = edit->info->frame, hits = 0, mismatches = 0;
+		auto key = make_query(edit, -1, false);
+		for (int i = 0; i < move_count; i++) {
+			// occasionally change the kind of the search, or jump elsewhere.
+			if (random(32) == 0)
+				key = make_query(edit, random(4) == 0 ? random(edit->info->layer_max + 1) : -1, random(2) == 0);
+			if (random(64) == 0) frame = random(edit->info->frame_max + 1);
+			bool const forward = random(3) != 0;
+
+			int const direct = step(edit, key, frame, forward);
+			int const idx = find_in_chain(key, frame, forward);
+			if (auto const& chain = cache.chains[forward ? 1 : 0];
+				idx >= 0 && static_cast<size_t>(idx) + 1 < chain.size()) {
+				hits++;
+				if (chain[idx + 1] != direct) {
+					if (mismatches++ == 0)
+						logging::warn(L"Boundary cache mismatch at move %d, frame %d (%s, layer %d): cached %d, direct %d.",
+							i, frame, forward ? L"right" : L"left", key.layer + 1, chain[idx + 1], direct);
+				}
 			}
+			frame = direct;
+			refresh(edit, key, frame);
 		}
-		return obj_end <= frame ? obj_end : obj_start;
+		invalidate();
+
+		// logging.
+		if (mismatches > 0)
+			logging::warn(L"Boundary cache self-test failed: %d mismatch(es) in %d moves. (seed %u)", mismatches, move_count, seed);
+		else logging::info(L"Boundary cache self-test passed: %d moves, %d hits. (seed %u)", move_count, hits, seed);
 	}
+#endif
+}
+
+// drops the caches of object positions, after this plugin has changed objects by itself,
+// as it's not known whether the host notifies of changes made in the same edit section.
+static void invalidate_object_caches()
+{
+	focus_cache.valid = false;
+	boundary_prefetch::invalidate();
 }
 
 
@@ -1533,16 +1804,14 @@ static void move_frame_wrap(EDIT_SECTION* edit, int layer, int frame)
 		d_frame = frame - edit->info->frame;
 	if (d_layer == 0 && d_frame == 0) return;
 
-	if (auto* queue = cursor_undo_queues.current(); queue != nullptr)
-		queue->check_forward(frame);
+	cursor_undo_queues.check_forward(cursor_state::from(*edit->info, layer, frame));
 	if (settings.search.suppress_shift) {
 		// fake keyboard state.
 		uint8_t key_state = 0x00;
 		if (write_key_state(VK_SHIFT, key_state)) {
 			// rewind the key state after the callback returns.
-			plugin_window.post_callback([](uintptr_t key_state) static
+			plugin_window.post_callback(PluginWindow::deferred::restore_key_state, +[](uint8_t state) static
 			{
-				uint8_t state = static_cast<uint8_t>(key_state);
 				write_key_state(VK_SHIFT, state);
 			}, key_state);
 		}
@@ -1559,7 +1828,7 @@ static void move_frame_wrap(EDIT_SECTION* edit, int layer, int frame)
 				if (tgt != nullptr && tgt != obj) {
 					pos = edit->get_object_layer_frame(tgt);
 					if (pos.start <= frame && frame <= pos.end) {
-						edit->set_focus_object(tgt);
+						change_focus_object(edit, tgt);
 					}
 				}
 			}
@@ -1571,30 +1840,19 @@ static void move_layer_core(EDIT_SECTION* edit, bool forward, bool allow_midpt)
 	// move to the next point of the layer the focused object is on.
 	// (if there's no focused object, fallback to the currently selected layer.)
 	auto const obj = edit->get_focus_object();
-	int const frame = edit->info->frame + (forward ? +1 : -1),
-		layer = obj != nullptr ?
-			edit->get_object_layer_frame(obj).layer :
-			edit->info->layer;
-	int next_frame = find_boundary(edit, layer, frame, forward, allow_midpt);
+	int const layer = obj != nullptr ?
+		edit->get_object_layer_frame(obj).layer :
+		edit->info->layer;
+	int next_frame = boundary_prefetch::find_next(edit,
+		boundary_prefetch::make_query(edit, layer, allow_midpt), forward);
 	move_frame_wrap(edit, edit->info->layer, next_frame);
 }
 
 static void move_scene_core(EDIT_SECTION* edit, bool forward, bool allow_midpt)
 {
 	// move to the next point of the entire scene.
-	int const frame = edit->info->frame + (forward ? +1 : -1);
-	int next_frame = forward ? edit->info->frame_max : 0;
-	for (int layer = edit->info->layer_max; layer >= 0; layer--) {
-		if ((settings.search.ignore_layers == Settings::ignore_layer::hidden ||
-			settings.search.ignore_layers == Settings::ignore_layer::hidden_or_locked)
-			&& !edit->get_layer_enable(layer)) continue;
-		if ((settings.search.ignore_layers == Settings::ignore_layer::locked ||
-			settings.search.ignore_layers == Settings::ignore_layer::hidden_or_locked)
-			&& edit->get_layer_lock(layer)) continue;
-
-		auto f = find_boundary(edit, layer, frame, forward, allow_midpt);
-		next_frame = (next_frame > f) == forward ? f : next_frame;
-	}
+	int next_frame = boundary_prefetch::find_next(edit,
+		boundary_prefetch::make_query(edit, -1, allow_midpt), forward);
 	move_frame_wrap(edit, edit->info->layer, next_frame);
 }
 
@@ -1697,6 +1955,30 @@ static void scroll_vert_to_selected(EDIT_SECTION* edit)
 ////////////////////////////////
 // object focus functions.
 ////////////////////////////////
+// the selected layer and the scroll position to follow the focused object.
+struct focus_follow_target {
+	int select_layer; // negative if unchanged.
+	int scroll_layer, scroll_frame;
+	bool scroll;
+};
+static void post_focus_follow(focus_follow_target const& target)
+{
+	// as call_edit_section() cannot be called within event callbacks
+	// (and nested edit sections cause infinite loops), post a window message callback to call it.
+	// only the latest request survives if several are made before it's processed.
+	plugin_window.post_callback(PluginWindow::deferred::follow_focus, +[](focus_follow_target target) static
+	{
+		edit_handle->call_edit_section_param(&target, [](void* param, EDIT_SECTION* edit) static
+		{
+			auto const& target = *static_cast<focus_follow_target const*>(param);
+			if (target.select_layer >= 0 && target.select_layer != edit->info->layer)
+				edit->set_cursor_layer_frame(target.select_layer, edit->info->frame);
+			if (target.scroll)
+				edit->set_display_layer_frame(target.scroll_layer, target.scroll_frame);
+		});
+	}, target);
+}
+
 static void focus_left_right_object(EDIT_SECTION* edit, bool right)
 {
 	OBJECT_HANDLE target_obj;
@@ -1711,7 +1993,7 @@ static void focus_left_right_object(EDIT_SECTION* edit, bool right)
 			std::get<0>(find_prev_obj(edit, pos.layer, pos.start - 1));
 	}
 
-	if (target_obj != nullptr) edit->set_focus_object(target_obj);
+	if (target_obj != nullptr) change_focus_object(edit, target_obj);
 }
 
 static void focus_above_below_layer_object(EDIT_SECTION* edit, bool below)
@@ -1741,7 +2023,7 @@ static void focus_above_below_layer_object(EDIT_SECTION* edit, bool below)
 
 	// then set the focus.
 	if (minimum.first != nullptr)
-		edit->set_focus_object(minimum.first);
+		change_focus_object(edit, minimum.first);
 }
 
 
@@ -1848,86 +2130,1720 @@ static void shift_bpm_grid_offset(EDIT_SECTION* edit, int frames)
 	edit->set_grid_bpm_list(bpm_list.data(), static_cast<int>(bpm_list.size()), sizeof(BPM_INFO));
 }
 
-
-////////////////////////////////
-// marker navigation.
-////////////////////////////////
-static int find_neighbor_mark(std::vector<int> const& marks, int frame, bool forward, int frame_max)
+// lists the frames of BPM grid lines that cover [frame_from, frame_until], in ascending order.
+// the start of each BPM grid setting is also treated as a grid line, unless `seg_starts` is false.
+static std::vector<int> collect_bpm_grid_frames(EDIT_SECTION* edit, int tempo_factor, bool by_measure,
+	int frame_from, int frame_until, bool seg_starts = true)
 {
-	auto it = std::partition_point(marks.begin(), marks.end(),
-		[f = forward ? frame + 1 : frame](int m) { return m < f; });
-	if (forward)
-		return it == marks.end() ? frame_max : *it;
-	else
-		return it == marks.begin() ? 0 : *(it - 1);
-}
+	Timeline_calc const tl_calc{
+		edit->info->rate,
+		edit->info->scale
+	};
 
-static void move_to_mark(EDIT_SECTION* edit, bool forward)
-{
-	int const frame = find_neighbor_mark(collect_mark_points(edit),
-		edit->info->frame, forward, edit->info->frame_max);
-	move_frame_wrap(edit, edit->info->layer, frame);
-}
+	std::vector<int> ret{};
+	auto const bpm_list = get_bpm_info(edit);
+	for (auto it_bpm = bpm_list.begin(); it_bpm != bpm_list.end(); it_bpm++) {
+		// the range of frames this setting applies to, [seg_start, seg_end).
+		int const seg_start = it_bpm == bpm_list.begin() ? 0 :
+			static_cast<int>(std::ceil(tl_calc.second_to_frame(it_bpm->start)));
+		int const seg_end = it_bpm + 1 == bpm_list.end() ? std::numeric_limits<int>::max() :
+			static_cast<int>(std::ceil(tl_calc.second_to_frame((it_bpm + 1)->start)));
+		if (seg_starts) ret.push_back(seg_start);
+		int const from = std::max(seg_start, frame_from), until = std::min(seg_end - 1, frame_until);
+		if (from > until) continue;
+
+		BPM_grid_calc const bpm_calc{
+			it_bpm->tempo * tempo_factor / (by_measure ? it_bpm->beat : 1),
+			it_bpm->start + it_bpm->offset,
+			tl_calc.rate, tl_calc.scale
+		};
 
-static void move_to_mark_absolute(EDIT_SECTION* edit, int index)
-{
-	auto const marks = collect_mark_points(edit);
-	if (static_cast<size_t>(index) >= marks.size()) return; // invalid.
-	move_frame_wrap(edit, edit->info->layer, marks[index]);
-}
+		// include one more line on each side, so the nearest line is always found.
+		double const beat_until = std::ceil(bpm_calc.frame_to_beat(until)) + 1;
+		for (double beat = std::floor(bpm_calc.frame_to_beat(from)) - 1; beat <= beat_until; beat++) {
+			int const f = bpm_calc.beat_to_frame_int(beat);
+			if (seg_start <= f && f < seg_end) ret.push_back(f);
+		}
+	}
 
-static void scroll_to_mark(EDIT_SECTION* edit, bool forward)
-{
-	int const half_num = edit->info->display_frame_num >> 1;
-	int const frame = find_neighbor_mark(collect_mark_points(edit),
-		edit->info->display_frame_start + half_num, forward, edit->info->frame_max);
-	edit->set_display_layer_frame(edit->info->display_layer_start, std::max(0, frame - half_num));
+	std::ranges::sort(ret);
+	ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+	return ret;
 }
 
-static void scroll_to_mark_absolute(EDIT_SECTION* edit, int index)
+static void quantize_selected_objects(EDIT_SECTION* edit, int tempo_factor, bool by_measure)
 {
-	auto const marks = collect_mark_points(edit);
-	if (static_cast<size_t>(index) >= marks.size()) return; // invalid.
-	int const half_num = edit->info->display_frame_num >> 1;
-	edit->set_display_layer_frame(edit->info->display_layer_start, std::max(0, marks[index] - half_num));
-}
+	auto targets = get_selected_objects(edit);
+	if (targets.empty()) return; // no operation.
 
-static void toggle_unnamed_mark(EDIT_SECTION* edit)
-{
-	auto const marks = collect_mark_points(edit);
-	int const frame = edit->info->frame;
+	// sort these objects by start, so the grid table can be walked in a single pass.
+	std::sort(targets.begin(), targets.end(), [](auto const& p1, auto const& p2) {
+		return p1.second.start < p2.second.start;
+	});
+	std::set<OBJECT_HANDLE> target_set{};
+	int frame_until = 0;
+	for (auto const& [obj, pos] : targets) {
+		target_set.emplace(obj);
+		frame_until = std::max(frame_until, pos.end + 1);
+	}
+	auto const grid = collect_bpm_grid_frames(edit, tempo_factor, by_measure,
+		targets.front().second.start, frame_until);
+
+	// find the nearest grid line for each start.
+	struct entry { OBJECT_HANDLE obj; OBJECT_LAYER_FRAME pos; int new_start; };
+	std::map<int, std::vector<entry>> layers{};
+	auto it_grid = grid.begin();
+	for (auto const& [obj, pos] : targets) {
+		while (it_grid + 1 != grid.end() && *(it_grid + 1) <= pos.start) it_grid++;
+		int new_start = *it_grid;
+		if (it_grid + 1 != grid.end() && *(it_grid + 1) - pos.start < pos.start - new_start)
+			new_start = *(it_grid + 1);
+		layers[pos.layer].push_back({ obj, pos, new_start });
+	}
+
+	uint32_t moved_count = 0, left_behind = 0;
+	for (auto& [layer, entries] : layers) {
+		auto const new_end = [](entry const& e) { return e.new_start + e.pos.end - e.pos.start; };
+
+		// an object that would overlap the previous quantized one goes to the next grid line,
+		// and one that would overlap other objects stays.
+		int free_from = 0;
+		for (auto& e : entries) {
+			if (e.new_start < free_from) {
+				auto const it = std::ranges::lower_bound(grid, free_from);
+				e.new_start = it != grid.end() ? *it : e.pos.start;
+			}
+			for (int f = e.new_start; e.new_start != e.pos.start && f <= new_end(e); ) {
+				auto const o = edit->find_object(layer, f);
+				if (o == nullptr) break;
+				auto const p = edit->get_object_layer_frame(o);
+				f = p.end + 1;
+				if (p.start > new_end(e)) break;
+				if (!target_set.contains(o)) e.new_start = e.pos.start; // collides.
+			}
+			free_from = std::max(free_from, new_end(e) + 1);
+		}
+
+		// objects that stay may still overlap the neighbors that moved. let those stay too.
+		for (size_t i = 1; i < entries.size(); ) {
+			auto& l = entries[i - 1]; auto& r = entries[i];
+			if (new_end(l) < r.new_start) { i++; continue; }
+			if (r.new_start != r.pos.start) r.new_start = r.pos.start;
+			else {
+				l.new_start = l.pos.start;
+				if (i > 1) i--; // check the previous pair again.
+			}
+		}
+
+		// move leftward ones from the left, and then rightward ones from the right,
+		// so every object moves into a space that is already free.
+		auto const move = [&](entry const& e)
+		{
+			if (edit->move_object(e.obj, layer, e.new_start)) moved_count++;
+			else left_behind++;
+		};
+		for (auto const& e : entries) if (e.new_start < e.pos.start) move(e);
+		for (auto const& e : entries | std::views::reverse) if (e.new_start > e.pos.start) move(e);
+	}
+
+	if (moved_count > 0) invalidate_object_caches();
+
+	// output an information message.
+	if (left_behind > 0)
+		logging::warn(L"Quantized %d object(s). (%d left behind.)", moved_count, left_behind);
+	else logging::info(L"Quantized %d object(s).", moved_count);
+}
+
+// refines the beat period and the phase by least squares on the points, each assigned to its nearest beat.
+// points farther than a quarter beat from the grid are left out as outliers.
+static std::pair<double, double> refine_beat_grid(std::span<double const> points, double period, double phase)
+{
+	double const t0 = points.front();
+	for (int iter = 0; iter < 4; iter++) {
+		double sk = 0, st = 0, skk = 0, skt = 0; size_t n = 0;
+		for (double const t : points) {
+			double const k = std::round((t - phase) / period);
+			if (std::abs(t - phase - k * period) > period / 4) continue;
+			sk += k; st += t - t0; skk += k * k; skt += k * (t - t0); n++;
+		}
+		double const den = n * skk - sk * sk;
+		if (n < 2 || den <= 0) break;
+		period = (n * skt - sk * st) / den;
+		phase = t0 + (st - period * sk) / n;
+	}
+	return { period, phase };
+}
+
+// estimates the beat period and the phase (in seconds) of the grid that best fits the points,
+// searching periods within ±8% of `period0`. each step is a single pass over the points.
+static std::pair<double, double> fit_beat_grid(std::vector<double> const& points, double period0)
+{
+	constexpr double pi2 = 2 * 3.14159265358979323846, span = 0.08;
+	double const t0 = points.front(), length = points.back() - t0;
+
+	// coarse search by the vector strength of the phases, on a subsample of the points.
+	// the steps are fine enough that the phase drifts less than a quarter beat over the whole range,
+	// and the subsample is thinned so the total cost stays around a million evaluations.
+	int const steps = std::clamp(static_cast<int>(std::ceil(span * 4 * length / period0)), 16, 4096);
+	size_t const samples = std::max<size_t>(256, (1 << 20) / (2 * steps + 1)),
+		stride = (points.size() + samples - 1) / samples;
+	double period = period0, phase = t0, best_strength = -1;
+	for (int i = -steps; i <= steps; i++) {
+		double const p = period0 * (1 + span * i / steps), w = pi2 / p;
+		double c = 0, s = 0;
+		for (size_t j = 0; j < points.size(); j += stride) {
+			double const a = w * (points[j] - t0);
+			c += std::cos(a); s += std::sin(a);
+		}
+		if (double const strength = c * c + s * s; strength > best_strength) {
+			best_strength = strength;
+			period = p; phase = t0 + std::atan2(s, c) / w;
+		}
+	}
+
+	// then refine with all points.
+	return refine_beat_grid(points, period, phase);
+}
+
+static void fit_bpm_grid_to_edit_points(EDIT_SECTION* edit)
+{
+	Timeline_calc const tl_calc{
+		edit->info->rate,
+		edit->info->scale
+	};
+
+	int const curr_frame = edit->info->frame;
+	auto bpm_list = get_bpm_info(edit);
+	auto const it_bpm = find_bpm_grid_at(bpm_list, curr_frame, tl_calc.rate, tl_calc.scale);
+
+	// the target layers are those of the selected objects, or the selected layer.
+	std::set<int> target_layers{};
+	for (auto const& [_, pos] : get_selected_objects(edit)) target_layers.insert(pos.layer);
+	if (target_layers.empty()) target_layers.insert(edit->info->layer);
+
+	// the range is between the marks around the cursor, within the BPM grid setting at the cursor.
+	auto const marks = collect_mark_points(edit);
+	int range_start = find_neighbor_mark(marks, curr_frame + 1, false, edit->info->frame_max);
+	int range_end = find_neighbor_mark(marks, curr_frame, true, edit->info->frame_max + 1);
+	if (it_bpm != bpm_list.begin())
+		range_start = std::max(range_start, static_cast<int>(std::ceil(tl_calc.second_to_frame(it_bpm->start))));
+	if (it_bpm + 1 != bpm_list.end())
+		range_end = std::min(range_end, static_cast<int>(std::ceil(tl_calc.second_to_frame((it_bpm + 1)->start))));
+
+	// collect the starts and ends of the objects as the edit points.
+	std::vector<int> frames{};
+	for (int const layer : target_layers) {
+		for (int f = range_start; f < range_end; ) {
+			auto const obj = edit->find_object(layer, f);
+			if (obj == nullptr) break;
+			auto const pos = edit->get_object_layer_frame(obj);
+			f = pos.end + 1;
+			if (pos.start >= range_start) frames.push_back(pos.start);
+			if (pos.end + 1 < range_end) frames.push_back(pos.end + 1);
+		}
+	}
+	std::ranges::sort(frames);
+	frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+	if (frames.size() < 4) {
+		logging::warn(L"Too few edit points to fit the BPM grid. (%d found.)", static_cast<int>(frames.size()));
+		return;
+	}
+
+	std::vector<double> points{};
+	points.reserve(frames.size());
+	for (int const f : frames) points.push_back(tl_calc.frame_to_second(f));
+	auto const [period, phase] = fit_beat_grid(points, 60.0 / it_bpm->tempo);
+	if (!(period > 60.0 / 1000)) {
+		logging::warn(L"Failed to fit the BPM grid.");
+		return;
+	}
+
+	// among the beat lines of the new grid, the one nearest the former measure line becomes the new measure line.
+	double const offset = phase - it_bpm->start;
+	it_bpm->tempo = static_cast<float>(60.0 / period);
+	it_bpm->offset = static_cast<float>(offset + period * std::round((it_bpm->offset - offset) / period));
+	edit->set_grid_bpm_list(bpm_list.data(), static_cast<int>(bpm_list.size()), sizeof(BPM_INFO));
+
+	// output an information message.
+	logging::info(L"Fitted the BPM grid to %d edit point(s): tempo %.3f, offset %.3f.",
+		static_cast<int>(frames.size()), it_bpm->tempo, it_bpm->offset);
+}
+
+// estimates the beat period and the phase from the tapped times in ascending order.
+// the period starts from the median interval so missed or doubled taps don't spoil it,
+// and the refinement leaves out the taps off the grid.
+static std::pair<double, double> estimate_tap_tempo(std::span<double const> taps)
+{
+	std::vector<double> intervals{};
+	intervals.reserve(taps.size());
+	for (size_t i = 1; i < taps.size(); i++) intervals.push_back(taps[i] - taps[i - 1]);
+	auto const mid = intervals.begin() + intervals.size() / 2;
+	std::nth_element(intervals.begin(), mid, intervals.end());
+	return refine_beat_grid(taps, *mid, taps.front());
+}
+
+namespace tap_tempo
+{
+	constexpr size_t min_taps = 4, max_taps = 64;
+	constexpr double reset_interval = 3.0; // in seconds.
+	constexpr UINT_PTR commit_timer_id = 3;
+
+	constinit struct {
+		std::vector<double> taps{}; // in seconds on the timeline.
+		int64_t first_count = 0;
+		int first_frame = 0, scene_id = -1;
+	} state{};
+
+	// applies the estimate to the BPM grid setting at the first tap, where a measure line goes.
+	static void commit(EDIT_SECTION* edit)
+	{
+		if (state.scene_id != edit->info->scene_id || state.taps.size() < min_taps) return;
+		auto const [period, phase] = estimate_tap_tempo(state.taps);
+		if (!(period > 60.0 / 1000)) return;
+
+		Timeline_calc const tl_calc{
+			edit->info->rate,
+			edit->info->scale
+		};
+		double const first_time = tl_calc.frame_to_second(state.first_frame);
+		auto bpm_list = get_bpm_info(edit);
+		auto const it_bpm = find_bpm_grid_at(bpm_list, state.first_frame, tl_calc.rate, tl_calc.scale);
+		it_bpm->tempo = static_cast<float>(60.0 / period);
+		it_bpm->offset = static_cast<float>(phase + period * std::round((first_time - phase) / period) - it_bpm->start);
+		edit->set_grid_bpm_list(bpm_list.data(), static_cast<int>(bpm_list.size()), sizeof(BPM_INFO));
+
+		// output an information message.
+		logging::info(L"Tap tempo: set the BPM grid to %.2f from %d tap(s).", it_bpm->tempo, static_cast<int>(state.taps.size()));
+	}
+
+	// the taps have paused long enough. the grid is changed only here,
+	// so a tapping session makes a single undo step in the host.
+	static void CALLBACK on_pause(HWND, UINT, UINT_PTR, DWORD)
+	{
+		if (plugin_window.root != nullptr) ::KillTimer(plugin_window.root, commit_timer_id);
+		edit_handle->call_edit_section_param(nullptr, [](void*, EDIT_SECTION* edit) static
+		{
+			commit(edit);
+			state.taps.clear();
+		});
+	}
+
+	static void tap(EDIT_SECTION* edit)
+	{
+		Timeline_calc const tl_calc{
+			edit->info->rate,
+			edit->info->scale
+		};
+
+		// timestamp by the performance counter, relative to the first tap.
+		LARGE_INTEGER count, freq;
+		::QueryPerformanceCounter(&count);
+		::QueryPerformanceFrequency(&freq);
+		double elapsed = static_cast<double>(count.QuadPart - state.first_count) / freq.QuadPart;
+
+		// wait for the next tap, or the end of the session.
+		// without the timer, every tap commits instead.
+		bool const deferred = plugin_window.root != nullptr &&
+			::SetTimer(plugin_window.root, commit_timer_id, static_cast<UINT>(reset_interval * 1000), &on_pause) != 0;
+
+		// start over if the pause was too long, or the scene has changed.
+		// the first tap is taken at the current frame.
+		double const first_time = tl_calc.frame_to_second(state.first_frame);
+		if (state.taps.empty() || state.scene_id != edit->info->scene_id ||
+			elapsed - (state.taps.back() - first_time) > reset_interval) {
+			state.taps.clear();
+			state.first_count = count.QuadPart;
+			state.first_frame = edit->info->frame;
+			state.scene_id = edit->info->scene_id;
+			state.taps.push_back(tl_calc.frame_to_second(state.first_frame));
+			logging::info(L"Tap tempo started.");
+			return;
+		}
+		state.taps.push_back(first_time + elapsed);
+		if (state.taps.size() > max_taps) state.taps.erase(state.taps.begin());
+		if (state.taps.size() < min_taps) return;
+		if (!deferred) {
+			commit(edit);
+			return;
+		}
+
+		// show the estimate so far.
+		auto const [period, _] = estimate_tap_tempo(state.taps);
+		if (period > 60.0 / 1000)
+			logging::info(L"Tap tempo: %.2f from %d tap(s).", 60.0 / period, static_cast<int>(state.taps.size()));
+	}
+}
+
+
+////////////////////////////////
+// marker navigation.
+////////////////////////////////
+static void move_to_mark(EDIT_SECTION* edit, bool forward)
+{
+	int const frame = find_neighbor_mark(collect_mark_points(edit),
+		edit->info->frame, forward, edit->info->frame_max);
+	move_frame_wrap(edit, edit->info->layer, frame);
+}
+
+static void move_to_mark_absolute(EDIT_SECTION* edit, int index)
+{
+	auto const marks = collect_mark_points(edit);
+	if (static_cast<size_t>(index) >= marks.size()) return; // invalid.
+	move_frame_wrap(edit, edit->info->layer, marks[index]);
+}
+
+static void scroll_to_mark(EDIT_SECTION* edit, bool forward)
+{
+	int const half_num = edit->info->display_frame_num >> 1;
+	int const frame = find_neighbor_mark(collect_mark_points(edit),
+		edit->info->display_frame_start + half_num, forward, edit->info->frame_max);
+	edit->set_display_layer_frame(edit->info->display_layer_start, std::max(0, frame - half_num));
+}
+
+static void scroll_to_mark_absolute(EDIT_SECTION* edit, int index)
+{
+	auto const marks = collect_mark_points(edit);
+	if (static_cast<size_t>(index) >= marks.size()) return; // invalid.
+	int const half_num = edit->info->display_frame_num >> 1;
+	edit->set_display_layer_frame(edit->info->display_layer_start, std::max(0, marks[index] - half_num));
+}
+
+static void toggle_unnamed_mark(EDIT_SECTION* edit)
+{
+	auto const marks = collect_mark_points(edit);
+	int const frame = edit->info->frame;
 	auto const it = std::partition_point(marks.begin(), marks.end(), [f = frame](int m) { return m < f; });
 
-	int state;
-	if (it != marks.end() && *it == frame) {
-		auto const name = edit->get_mark_frame_memo(frame);
-		if (name == nullptr || *name == L'\0') {
-			edit->clear_mark_frame(frame);
-			state = 1;
-		}
-		else state = 2;
+	int state;
+	if (it != marks.end() && *it == frame) {
+		auto const name = edit->get_mark_frame_memo(frame);
+		if (name == nullptr || *name == L'\0') {
+			edit->clear_mark_frame(frame);
+			state = 1;
+		}
+		else state = 2;
+	}
+	else {
+		edit->set_mark_frame(frame, nullptr);
+		state = 0;
+	}
+
+	// output an information message.
+	constexpr wchar_t const* pats[] = {
+		L"Created an unnamed mark at %d F.",
+		L"Removed an unnamed mark at %d F.",
+		L"Cannot remove the mark at %d F, because it has a valid name.",
+	};
+	logging::info(pats[state], frame);
+}
+
+// places unnamed marks on the measure or beat lines, between the marks around the cursor
+// or across the visible range. only the lines without marks get new ones.
+static void create_marks_on_bpm_grid(EDIT_SECTION* edit, bool by_measure, bool visible)
+{
+	auto const marks = collect_mark_points(edit);
+	int range_start, range_end;
+	if (visible) {
+		range_start = edit->info->display_frame_start;
+		range_end = edit->info->display_frame_start + edit->info->display_frame_num - 1;
+	}
+	else {
+		range_start = find_neighbor_mark(marks, edit->info->frame + 1, false, edit->info->frame_max);
+		range_end = find_neighbor_mark(marks, edit->info->frame, true, edit->info->frame_max);
+	}
+	range_end = std::min(range_end, edit->info->frame_max);
+
+	uint32_t created_count = 0;
+	auto it_mark = marks.begin();
+	for (int const frame : collect_bpm_grid_frames(edit, 1, by_measure, range_start, range_end, false)) {
+		if (frame < range_start || frame > range_end) continue;
+		while (it_mark != marks.end() && *it_mark < frame) it_mark++;
+		if (it_mark != marks.end() && *it_mark == frame) continue; // already marked.
+		edit->set_mark_frame(frame, nullptr);
+		created_count++;
+	}
+
+	// output an information message.
+	logging::info(L"Created %d mark(s) on the %s lines.", created_count, by_measure ? L"measure" : L"beat");
+}
+
+
+////////////////////////////////
+// onset detection.
+////////////////////////////////
+namespace onset_detection
+{
+	// streaming reader of PCM samples in a WAV file, mixed down to mono.
+	class wav_reader {
+		HANDLE file = INVALID_HANDLE_VALUE;
+		uint64_t data_left = 0;
+		uint32_t channels = 0, bits = 0, block_align = 0;
+		bool is_float = false;
+		bool size_unknown = false; // the size of "data" was left 0 by the writer.
+		std::vector<std::byte> buf{};
+
+		bool read_exact(void* dst, uint32_t size) const
+		{
+			DWORD read;
+			return ::ReadFile(file, dst, size, &read, nullptr) != FALSE && read == size;
+		}
+		bool skip(int64_t size) const
+		{
+			return ::SetFilePointerEx(file, LARGE_INTEGER{ .QuadPart = size }, nullptr, FILE_CURRENT) != FALSE;
+		}
+		uint64_t bytes_to_end() const
+		{
+			LARGE_INTEGER pos, size;
+			if (::SetFilePointerEx(file, LARGE_INTEGER{}, &pos, FILE_CURRENT) == FALSE ||
+				::GetFileSizeEx(file, &size) == FALSE) return 0;
+			return static_cast<uint64_t>(std::max<int64_t>(size.QuadPart - pos.QuadPart, 0));
+		}
+
+		// the position of what looks like the header of a chunk following "data",
+		// such as metadata appended after the recording, or `len` if none.
+		size_t find_chunk_header(size_t len) const
+		{
+			constexpr std::string_view ids[] = { "LIST", "id3 ", "ID3 ", "cue ", "smpl", "bext", "JUNK", "fact" };
+			for (size_t k = 0; k + 4 <= len; k += block_align) {
+				std::string_view const id{ reinterpret_cast<char const*>(buf.data()) + k, 4 };
+				if (std::ranges::find(ids, id) == std::end(ids)) continue;
+				if (k + 8 > len) return k; // the size is in the next read.
+				uint32_t size; std::memcpy(&size, buf.data() + k + 4, 4);
+				if (size <= len - k - 8 + data_left) return k; // the chunk fits in the rest of the file.
+			}
+			return len;
+		}
+
+	public:
+		uint32_t sample_rate = 0;
+
+		wav_reader(std::wstring const& path)
+		{
+			file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+				OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return;
+
+			// walk the RIFF chunks until "data", reading "fmt " on the way.
+			char riff[12];
+			if (!read_exact(riff, sizeof(riff)) ||
+				std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) return;
+			uint32_t format = 0;
+			while (true) {
+				struct { char id[4]; uint32_t size; } chunk;
+				if (!read_exact(&chunk, sizeof(chunk))) return;
+				if (std::memcmp(chunk.id, "fmt ", 4) == 0 && chunk.size >= 16) {
+					uint8_t fmt[40]{};
+					uint32_t const len = std::min<uint32_t>(chunk.size, sizeof(fmt));
+					if (!read_exact(fmt, len) || !skip((chunk.size - len) + (chunk.size & 1))) return;
+					auto const u16 = [&](size_t pos) { return static_cast<uint32_t>(fmt[pos] | fmt[pos + 1] << 8); };
+					format = u16(0); channels = u16(2);
+					sample_rate = u16(4) | u16(6) << 16;
+					block_align = u16(12); bits = u16(14);
+					if (format == 0xfffe && len >= 26) format = u16(24); // WAVE_FORMAT_EXTENSIBLE.
+				}
+				else if (std::memcmp(chunk.id, "data", 4) == 0) {
+					// the size can be left 0 or 0xffffffff for a file being recorded, or larger than 4 GiB.
+					// read up to the end of the file then, and for 0, up to a chunk appended later.
+					uint64_t const available = bytes_to_end();
+					size_unknown = chunk.size == 0;
+					data_left = chunk.size == 0 || chunk.size == 0xffffffff ? available
+						: std::min<uint64_t>(chunk.size, available);
+					break;
+				}
+				else if (!skip(chunk.size + (chunk.size & 1))) return;
+			}
+
+			// accept integer PCM of 8 to 32 bits, and 32-bit floating point.
+			is_float = format == 3;
+			if (!((format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) || (is_float && bits == 32)) ||
+				channels == 0 || block_align != channels * bits / 8 || sample_rate == 0)
+				sample_rate = 0;
+		}
+		~wav_reader()
+		{
+			if (file != INVALID_HANDLE_VALUE) ::CloseHandle(file);
+		}
+		wav_reader(wav_reader const&) = delete;
+		wav_reader& operator=(wav_reader const&) = delete;
+
+		bool is_valid() const { return sample_rate > 0; }
+
+		// reads the next chunk of samples into `out`, mixed to mono in [-1, 1].
+		// returns false at the end of the data.
+		bool read(std::vector<float>& out)
+		{
+			constexpr uint32_t chunk_frames = 16384;
+			uint32_t const size = static_cast<uint32_t>(std::min<uint64_t>(data_left, chunk_frames * block_align));
+			buf.resize(size);
+			DWORD read;
+			if (size == 0 || ::ReadFile(file, buf.data(), size, &read, nullptr) == FALSE) return false;
+			data_left -= size;
+			if (size_unknown) {
+				if (size_t const len = find_chunk_header(read); len < read) {
+					read = static_cast<DWORD>(len);
+					data_left = 0;
+				}
+			}
+
+			uint32_t const frames = read / block_align;
+			out.resize(frames);
+			auto const* p = reinterpret_cast<uint8_t const*>(buf.data());
+			float const scale = 1.0f / channels;
+			for (uint32_t i = 0; i < frames; i++) {
+				float sum = 0;
+				for (uint32_t c = 0; c < channels; c++, p += bits / 8) {
+					switch (bits) {
+					case 8: sum += (p[0] - 128) / 128.0f; break;
+					case 16: sum += static_cast<int16_t>(p[0] | p[1] << 8) / 32768.0f; break;
+					case 24: sum += static_cast<int32_t>(p[0] << 8 | p[1] << 16 | p[2] << 24) / 2147483648.0f; break;
+					case 32:
+						if (is_float) { float f; std::memcpy(&f, p, 4); sum += f; }
+						else { int32_t v; std::memcpy(&v, p, 4); sum += v / 2147483648.0f; }
+						break;
+					}
+				}
+				out[i] = sum * scale;
+			}
+			return frames > 0;
+		}
+	};
+
+	// spectral flux of the short-time Fourier transform, computed as the samples are pushed.
+	// the spectra are kept as separate arrays of real and imaginary parts, so the loops vectorize.
+	class flux_detector {
+	public:
+		static constexpr size_t fft_size = 512, hop = fft_size / 2, bins = fft_size / 2;
+		std::vector<float> flux{}; // one value per hop.
+
+		flux_detector()
+		{
+			constexpr double pi = 3.14159265358979323846;
+			for (size_t i = 0; i < fft_size; i++) {
+				window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2 * pi * i / fft_size));
+				size_t r = 0;
+				for (size_t b = 1, j = i; b < fft_size; b <<= 1, j >>= 1) r = (r << 1) | (j & 1);
+				bit_reverse[i] = static_cast<uint16_t>(r);
+			}
+			for (size_t i = 0; i < fft_size / 2; i++) {
+				tw_re[i] = static_cast<float>(std::cos(2 * pi * i / fft_size));
+				tw_im[i] = static_cast<float>(-std::sin(2 * pi * i / fft_size));
+			}
+		}
+
+		void push(std::span<float const> samples)
+		{
+			for (float const s : samples) {
+				input[filled++] = s;
+				if (filled < fft_size) continue;
+				process();
+				std::memmove(input.data(), input.data() + hop, (fft_size - hop) * sizeof(float));
+				filled = fft_size - hop;
+			}
+		}
+
+	private:
+		std::array<float, fft_size> input{}, window{}, re{}, im{};
+		std::array<float, fft_size / 2> tw_re{}, tw_im{};
+		std::array<float, bins> prev_mag{};
+		std::array<uint16_t, fft_size> bit_reverse{};
+		size_t filled = 0;
+
+		void process()
+		{
+			// windowing and the iterative radix-2 FFT.
+			for (size_t i = 0; i < fft_size; i++) {
+				re[bit_reverse[i]] = input[i] * window[i];
+				im[i] = 0;
+			}
+			for (size_t half = 1, step = fft_size / 2; half < fft_size; half <<= 1, step >>= 1) {
+				for (size_t k = 0; k < fft_size; k += 2 * half) {
+					for (size_t j = 0; j < half; j++) {
+						float const wr = tw_re[j * step], wi = tw_im[j * step];
+						size_t const a = k + j, b = a + half;
+						float const xr = re[b] * wr - im[b] * wi, xi = re[b] * wi + im[b] * wr;
+						re[b] = re[a] - xr; im[b] = im[a] - xi;
+						re[a] += xr; im[a] += xi;
+					}
+				}
+			}
+
+			// sum of the increases of the magnitudes, compressed by the square root.
+			// (a logarithm would double the time of the whole analysis.)
+			float sum = 0;
+			for (size_t i = 0; i < bins; i++) {
+				float const mag = std::sqrt(std::sqrt(re[i] * re[i] + im[i] * im[i]));
+				sum += std::max(mag - prev_mag[i], 0.0f);
+				prev_mag[i] = mag;
+			}
+			flux.push_back(flux.empty() ? 0 : sum); // the first frame has nothing to compare with.
+		}
+	};
+
+	struct analysis {
+		std::vector<double> onsets{}; // in seconds from the start of the audio.
+		double period = 0; // estimated beat period in seconds, or 0 if unknown.
+	};
+
+	// finds the local peaks of the flux that stand out of the moving average.
+	static std::vector<double> pick_peaks(std::vector<float>& flux, double hop_sec, double offset_sec)
+	{
+		// normalize to zero mean and unit variance.
+		double sum = 0, sum2 = 0;
+		for (float const v : flux) { sum += v; sum2 += static_cast<double>(v) * v; }
+		double const mean = sum / flux.size(), sd = std::sqrt(std::max(sum2 / flux.size() - mean * mean, 1e-12));
+		for (float& v : flux) v = static_cast<float>((v - mean) / sd);
+
+		// a peak is the maximum within ±30 ms, above the average within ±200 ms by the threshold,
+		// and at least 50 ms after the previous one.
+		constexpr double threshold = 0.5;
+		int const n = static_cast<int>(flux.size()),
+			w_max = std::max(1, static_cast<int>(0.03 / hop_sec)),
+			w_avg = std::max(1, static_cast<int>(0.2 / hop_sec)),
+			min_gap = std::max(1, static_cast<int>(0.05 / hop_sec));
+		std::vector<double> ret{};
+		double avg_sum = 0;
+		for (int i = 0; i < std::min(w_avg, n); i++) avg_sum += flux[i];
+		for (int i = 0, last = -min_gap; i < n; i++) {
+			// slide the averaging window to [i - w_avg, i + w_avg].
+			if (i + w_avg < n) avg_sum += flux[i + w_avg];
+			if (i - w_avg - 1 >= 0) avg_sum -= flux[i - w_avg - 1];
+			int const avg_len = std::min(i + w_avg, n - 1) - std::max(i - w_avg, 0) + 1;
+
+			if (i - last < min_gap || flux[i] < avg_sum / avg_len + threshold) continue;
+			bool is_max = true;
+			for (int j = std::max(i - w_max, 0); j <= std::min(i + w_max, n - 1) && is_max; j++)
+				is_max = flux[j] <= flux[i];
+			if (!is_max) continue;
+			ret.push_back(i * hop_sec + offset_sec);
+			last = i;
+		}
+		return ret;
+	}
+
+	// estimates the beat period from the autocorrelation of the flux, within 60 to 200 BPM.
+	// lags near 120 BPM are slightly preferred, to settle the octave ambiguity.
+	static double estimate_period(std::vector<float> const& flux, double hop_sec)
+	{
+		int const n = static_cast<int>(flux.size()),
+			lag_min = static_cast<int>(60.0 / 200 / hop_sec), lag_max = static_cast<int>(std::ceil(60.0 / 60 / hop_sec));
+		if (lag_min < 1 || lag_max + 1 >= n) return 0;
+		std::vector<double> ac(lag_max + 2);
+		for (int lag = lag_min - 1; lag <= lag_max + 1; lag++) {
+			double s = 0;
+			for (int i = lag; i < n; i++) s += std::max(flux[i], 0.0f) * std::max(flux[i - lag], 0.0f);
+			ac[lag] = s / (n - lag);
+		}
+		int best = 0; double best_score = -1;
+		for (int lag = lag_min; lag <= lag_max; lag++) {
+			double const octave = std::log2(60.0 / (lag * hop_sec) / 120);
+			double const score = ac[lag] * std::exp(-0.5 * octave * octave);
+			if (ac[lag] >= ac[lag - 1] && ac[lag] >= ac[lag + 1] && score > best_score) {
+				best_score = score; best = lag;
+			}
+		}
+		if (best == 0) return 0;
+
+		// parabolic interpolation around the peak.
+		double const l = ac[best - 1], c = ac[best], r = ac[best + 1], den = l - 2 * c + r;
+		return (best + (den < 0 ? 0.5 * (l - r) / den : 0)) * hop_sec;
+	}
+
+	// analyses the WAV file in chunks. the memory used is the buffers plus a float per hop.
+	static std::optional<analysis> analyze(std::wstring const& path)
+	{
+		wav_reader wav{ path };
+		if (!wav.is_valid()) {
+			logging::warn(L"Failed to read the WAV file, or its format is not supported.");
+			return std::nullopt;
+		}
+
+		// downsample to around 11 kHz by averaging, which is enough for onsets.
+		uint32_t const decimation = std::max<uint32_t>(1, wav.sample_rate / 11025);
+		double const rate = static_cast<double>(wav.sample_rate) / decimation;
+		flux_detector detector{};
+		std::vector<float> chunk{}, decimated{};
+		float acc = 0; uint32_t acc_count = 0;
+		while (wav.read(chunk)) {
+			decimated.clear();
+			for (float const s : chunk) {
+				acc += s;
+				if (++acc_count < decimation) continue;
+				decimated.push_back(acc / decimation);
+				acc = 0; acc_count = 0;
+			}
+			detector.push(decimated);
+		}
+		if (detector.flux.size() < 4) {
+			logging::warn(L"The audio is too short to analyse.");
+			return std::nullopt;
+		}
+
+		// each flux value is for the window centered at this offset.
+		double const hop_sec = flux_detector::hop / rate, offset_sec = flux_detector::fft_size / 2 / rate;
+		analysis ret{};
+		ret.onsets = pick_peaks(detector.flux, hop_sec, offset_sec);
+		ret.period = estimate_period(detector.flux, hop_sec);
+		return ret;
+	}
+
+	static bool pick_wav_file(std::wstring& path)
+	{
+		wchar_t buf[MAX_PATH]{};
+		OPENFILENAMEW ofn{
+			.lStructSize = sizeof(ofn),
+			.hwndOwner = edit_handle->get_host_app_window(),
+			.lpstrFilter = L"WAV (*.wav)\0*.wav\0\0",
+			.lpstrFile = buf, .nMaxFile = static_cast<DWORD>(std::size(buf)),
+			.Flags = OFN_FILEMUSTEXIST | OFN_HIDEREADONLY | OFN_NOCHANGEDIR,
+		};
+		if (::GetOpenFileNameW(&ofn) == FALSE) return false;
+		path = buf;
+		return true;
+	}
+
+	// creates marks at the onsets, with the start of the audio at the cursor.
+	static void create_marks(EDIT_SECTION* edit, analysis const& result)
+	{
+		Timeline_calc const tl_calc{
+			edit->info->rate,
+			edit->info->scale
+		};
+
+		auto const marks = collect_mark_points(edit);
+		uint32_t created_count = 0;
+		int prev_frame = -1;
+		for (double const t : result.onsets) {
+			int const frame = edit->info->frame + static_cast<int>(std::round(tl_calc.second_to_frame(t)));
+			if (frame > edit->info->frame_max) break;
+			if (frame == prev_frame || std::ranges::binary_search(marks, frame)) continue;
+			edit->set_mark_frame(frame, nullptr);
+			prev_frame = frame;
+			created_count++;
+		}
+
+		// output an information message.
+		logging::info(L"Created %d mark(s) from %d onset(s).", created_count, static_cast<int>(result.onsets.size()));
+	}
+
+	// fits the BPM grid setting at the cursor to the onsets, with the start of the audio at the cursor.
+	static void fit_bpm_grid(EDIT_SECTION* edit, analysis const& result)
+	{
+		if (result.period <= 0 || result.onsets.size() < 4) {
+			logging::warn(L"Failed to estimate the tempo of the audio.");
+			return;
+		}
+
+		Timeline_calc const tl_calc{
+			edit->info->rate,
+			edit->info->scale
+		};
+		double const start = tl_calc.frame_to_second(edit->info->frame);
+		std::vector<double> points{};
+		points.reserve(result.onsets.size());
+		for (double const t : result.onsets) points.push_back(start + t);
+		auto const [period, phase] = fit_beat_grid(points, result.period);
+		if (!(period > 60.0 / 1000)) {
+			logging::warn(L"Failed to estimate the tempo of the audio.");
+			return;
+		}
+
+		// a measure line goes to the beat nearest the first onset.
+		auto bpm_list = get_bpm_info(edit);
+		auto const it_bpm = find_bpm_grid_at(bpm_list, edit->info->frame, tl_calc.rate, tl_calc.scale);
+		it_bpm->tempo = static_cast<float>(60.0 / period);
+		it_bpm->offset = static_cast<float>(phase + period * std::round((points.front() - phase) / period) - it_bpm->start);
+		edit->set_grid_bpm_list(bpm_list.data(), static_cast<int>(bpm_list.size()), sizeof(BPM_INFO));
+
+		// output an information message.
+		logging::info(L"Fitted the BPM grid to the audio: tempo %.3f, offset %.3f.", it_bpm->tempo, it_bpm->offset);
+	}
+
+	// the file dialog is shown outside the edit section, so the request is posted first,
+	// and the result is applied in a new edit section.
+	static void request(bool fit_bpm)
+	{
+		plugin_window.post_callback(PluginWindow::deferred::analyze_audio, +[](bool fit_bpm) static
+		{
+			std::wstring path;
+			if (!pick_wav_file(path)) return;
+
+			uint64_t const t0 = ::GetTickCount64();
+			auto const result = analyze(path);
+			if (!result) return;
+			logging::info(L"Found %d onset(s) in the audio in %d ms.",
+				static_cast<int>(result->onsets.size()), static_cast<int>(::GetTickCount64() - t0));
+
+			std::pair<analysis const*, bool> param{ &*result, fit_bpm };
+			edit_handle->call_edit_section_param(&param, [](void* param, EDIT_SECTION* edit) static
+			{
+				auto const& [result, fit_bpm] = *static_cast<std::pair<analysis const*, bool> const*>(param);
+				if (fit_bpm) fit_bpm_grid(edit, *result);
+				else create_marks(edit, *result);
+			});
+		}, fit_bpm);
+	}
+}
+
+
+////////////////////////////////
+// edit point export.
+////////////////////////////////
+namespace edit_point_export
+{
+	// at the same frame, points are ordered by this.
+	enum class kind : uint8_t {
+		measure, mark, object_end, object_start, section,
+	};
+	constexpr char const* kind_names[] = { "measure", "mark", "end", "start", "section" };
+
+	struct point {
+		int frame;
+		kind type;
+		int layer; // -1 for marks and measures.
+		int index; // the section index, or the measure number.
+
+		auto operator<=>(point const&) const = default;
+	};
+
+	// yields the edit points of the scene in ascending order, by merging the sorted sequences
+	// of each layer, the marks and the measure lines. the memory used is per layer, not per point.
+	// with `objects_only`, marks and measure lines are left out.
+	class point_merger {
+		EDIT_SECTION* const edit;
+
+		// each layer walks its objects with their midpoints.
+		struct layer_state {
+			std::vector<int> midpoints{};
+			size_t idx = 0;
+		};
+		std::vector<layer_state> layers{};
+
+		std::vector<int> const marks;
+		size_t mark_idx = 0;
+
+		std::vector<BPM_INFO> const bpm_list;
+		size_t bpm_idx = 0;
+		double beat = std::numeric_limits<double>::quiet_NaN(); // NaN at the start of a setting.
+		int last_measure = -1, measure_count = 0;
+
+		// the head of each sequence, indexed by the layers, then marks and measures.
+		std::priority_queue<std::pair<point, size_t>, std::vector<std::pair<point, size_t>>, std::greater<>> heads{};
+
+		std::optional<point> next_object_point(int layer)
+		{
+			auto& state = layers[layer];
+			if (state.idx >= state.midpoints.size()) {
+				auto const obj = edit->find_object(layer, state.midpoints.empty() ? 0 : state.midpoints.back());
+				if (obj == nullptr) return std::nullopt;
+				state.midpoints = find_midpoints(edit, obj);
+				state.idx = 0;
+			}
+			size_t const i = state.idx++;
+			return point{ state.midpoints[i],
+				i == 0 ? kind::object_start : i + 1 == state.midpoints.size() ? kind::object_end : kind::section,
+				layer, static_cast<int>(i) };
+		}
+		std::optional<point> next_mark()
+		{
+			if (mark_idx >= marks.size()) return std::nullopt;
+			return point{ marks[mark_idx++], kind::mark, -1, 0 };
+		}
+		std::optional<point> next_measure()
+		{
+			Timeline_calc const tl_calc{ edit->info->rate, edit->info->scale };
+			while (bpm_idx < bpm_list.size()) {
+				auto const it_bpm = bpm_list.begin() + bpm_idx;
+				int const seg_start = it_bpm == bpm_list.begin() ? 0 :
+					static_cast<int>(std::ceil(tl_calc.second_to_frame(it_bpm->start)));
+				int const seg_end = it_bpm + 1 == bpm_list.end() ? std::numeric_limits<int>::max() :
+					static_cast<int>(std::ceil(tl_calc.second_to_frame((it_bpm + 1)->start)));
+				BPM_grid_calc const bpm_calc{
+					it_bpm->tempo / it_bpm->beat,
+					it_bpm->start + it_bpm->offset,
+					tl_calc.rate, tl_calc.scale
+				};
+
+				// the start of each setting is also a measure line.
+				int frame;
+				if (std::isnan(beat)) {
+					frame = seg_start;
+					beat = std::ceil(bpm_calc.frame_to_beat(seg_start));
+				}
+				else frame = bpm_calc.beat_to_frame_int(beat++);
+				if (frame >= seg_end || frame > edit->info->frame_max) {
+					bpm_idx++;
+					beat = std::numeric_limits<double>::quiet_NaN();
+					continue;
+				}
+				if (frame <= last_measure) continue;
+				last_measure = frame;
+				return point{ frame, kind::measure, -1, ++measure_count };
+			}
+			return std::nullopt;
+		}
+		std::optional<point> next_of(size_t seq)
+		{
+			if (seq < layers.size()) return next_object_point(static_cast<int>(seq));
+			if (seq == layers.size()) return next_mark();
+			return next_measure();
+		}
+
+	public:
+		point_merger(EDIT_SECTION* edit, bool objects_only = false)
+			: edit{ edit }
+			, marks{ objects_only ? std::vector<int>{} : collect_mark_points(edit) }
+			, bpm_list{ objects_only ? std::vector<BPM_INFO>{} : get_bpm_info(edit) }
+		{
+			layers.resize(static_cast<size_t>(edit->info->layer_max + 1));
+			for (size_t seq = 0; seq < layers.size() + 2; seq++) {
+				if (seq < layers.size() && is_layer_ignored(edit, static_cast<int>(seq))) continue;
+				if (auto const p = next_of(seq)) heads.emplace(*p, seq);
+			}
+		}
+
+		std::optional<point> next()
+		{
+			if (heads.empty()) return std::nullopt;
+			auto const [p, seq] = heads.top();
+			heads.pop();
+			if (auto const q = next_of(seq)) heads.emplace(*q, seq);
+			return p;
+		}
+	};
+
+	// writes to a file through a fixed-size buffer.
+	class buffered_writer {
+		HANDLE file;
+		std::array<char, 1 << 16> buf;
+		size_t used = 0;
+		bool failed = false;
+
+	public:
+		buffered_writer(std::wstring const& path)
+		{
+			file = ::CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr,
+				CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			failed = file == INVALID_HANDLE_VALUE;
+		}
+		~buffered_writer()
+		{
+			if (file == INVALID_HANDLE_VALUE) return;
+			flush();
+			::CloseHandle(file);
+		}
+		buffered_writer(buffered_writer const&) = delete;
+		buffered_writer& operator=(buffered_writer const&) = delete;
+
+		bool ok() const { return !failed; }
+
+		void flush()
+		{
+			DWORD written;
+			if (!failed && used > 0)
+				failed = ::WriteFile(file, buf.data(), static_cast<DWORD>(used), &written, nullptr) == FALSE || written != used;
+			used = 0;
+		}
+		void write(std::string_view s)
+		{
+			while (!s.empty()) {
+				if (used == buf.size()) flush();
+				size_t const n = std::min(s.size(), buf.size() - used);
+				std::memcpy(buf.data() + used, s.data(), n);
+				used += n; s.remove_prefix(n);
+			}
+		}
+		template<class... TArgs>
+		void print(char const* fmt, TArgs... args)
+		{
+			char tmp[256];
+			int const n = std::snprintf(tmp, sizeof(tmp), fmt, args...);
+			write({ tmp, static_cast<size_t>(std::clamp(n, 0, static_cast<int>(sizeof(tmp)) - 1)) });
+		}
+		void write_utf8(std::wstring_view text)
+		{
+			if (text.empty()) return;
+			std::string bytes(::WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr), '\0');
+			::WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), bytes.data(), static_cast<int>(bytes.size()), nullptr, nullptr);
+			write(bytes);
+		}
+	};
+
+	// non-drop timecode at the rounded frame rate.
+	static std::array<char, 16> timecode(int frame, int fps)
+	{
+		std::array<char, 16> ret{};
+		int const ff = frame % fps, s = frame / fps;
+		std::snprintf(ret.data(), ret.size(), "%02d:%02d:%02d:%02d", s / 3600, s / 60 % 60, s % 60, ff);
+		return ret;
+	}
+
+	static wchar_t const* mark_memo(EDIT_SECTION* edit, int frame)
+	{
+		auto const memo = edit->get_mark_frame_memo(frame);
+		return memo != nullptr ? memo : L"";
+	}
+
+	static uint32_t write_csv(EDIT_SECTION* edit, buffered_writer& out)
+	{
+		int const fps = std::max(1, (edit->info->rate + edit->info->scale / 2) / edit->info->scale);
+		Timeline_calc const tl_calc{ edit->info->rate, edit->info->scale };
+
+		out.write("\xef\xbb\xbf" "frame,timecode,seconds,type,layer,detail\r\n");
+		uint32_t count = 0;
+		point_merger points{ edit };
+		while (auto const p = points.next()) {
+			out.print("%d,%s,%.3f,%s,", p->frame, timecode(p->frame, fps).data(),
+				tl_calc.frame_to_second(p->frame), kind_names[static_cast<size_t>(p->type)]);
+			if (p->layer >= 0) out.print("%d", p->layer + 1);
+			out.write(",");
+			switch (p->type) {
+			case kind::section: case kind::measure:
+				out.print("%d", p->index);
+				break;
+			case kind::mark:
+			{
+				// quote the memo, doubling the quotes in it.
+				std::wstring memo = mark_memo(edit, p->frame);
+				for (size_t pos = 0; (pos = memo.find(L'"', pos)) != memo.npos; pos += 2) memo.insert(pos, 1, L'"');
+				out.write("\"");
+				out.write_utf8(memo);
+				out.write("\"");
+				break;
+			}
+			default: break;
+			}
+			out.write("\r\n");
+			count++;
+		}
+		return count;
+	}
+
+	// one cut event per interval between consecutive edit points,
+	// with the points at its head listed in the comment lines.
+	static uint32_t write_edl(EDIT_SECTION* edit, buffered_writer& out, std::wstring_view title)
+	{
+		int const fps = std::max(1, (edit->info->rate + edit->info->scale / 2) / edit->info->scale);
+
+		out.write("TITLE: ");
+		out.write_utf8(title);
+		out.write("\r\nFCM: NON-DROP FRAME\r\n\r\n");
+		uint32_t count = 0, event = 0;
+		int head = -1;
+		std::string comments{};
+		auto const write_event = [&](int frame_in, int frame_out)
+		{
+			auto const tc_in = timecode(frame_in, fps), tc_out = timecode(frame_out, fps);
+			out.print("%03u  AX       V     C        %s %s %s %s\r\n",
+				++event, tc_in.data(), tc_out.data(), tc_in.data(), tc_out.data());
+			out.write(comments);
+			comments.clear();
+		};
+
+		point_merger points{ edit };
+		while (auto const p = points.next()) {
+			if (p->frame != head) {
+				if (head >= 0) write_event(head, p->frame);
+				head = p->frame;
+			}
+			comments += "* EDIT POINT: ";
+			comments += kind_names[static_cast<size_t>(p->type)];
+			char tmp[32];
+			switch (p->type) {
+			case kind::object_start: case kind::object_end:
+				std::snprintf(tmp, sizeof(tmp), " L%d", p->layer + 1);
+				comments += tmp;
+				break;
+			case kind::section:
+				std::snprintf(tmp, sizeof(tmp), " L%d #%d", p->layer + 1, p->index);
+				comments += tmp;
+				break;
+			case kind::measure:
+				std::snprintf(tmp, sizeof(tmp), " #%d", p->index);
+				comments += tmp;
+				break;
+			case kind::mark:
+				if (std::wstring_view const memo = mark_memo(edit, p->frame); !memo.empty()) {
+					int const len = ::WideCharToMultiByte(CP_UTF8, 0, memo.data(), static_cast<int>(memo.size()), nullptr, 0, nullptr, nullptr);
+					size_t const pos = comments.size() + 1;
+					comments.resize(pos + len);
+					comments[pos - 1] = ' ';
+					::WideCharToMultiByte(CP_UTF8, 0, memo.data(), static_cast<int>(memo.size()), comments.data() + pos, len, nullptr, nullptr);
+				}
+				break;
+			}
+			comments += "\r\n";
+			count++;
+		}
+		if (head >= 0) write_event(head, head + 1);
+		return count;
+	}
+
+	static bool pick_file(std::wstring& path, bool edl)
+	{
+		wchar_t buf[MAX_PATH]{};
+		OPENFILENAMEW ofn{
+			.lStructSize = sizeof(ofn),
+			.hwndOwner = edit_handle->get_host_app_window(),
+			.lpstrFilter = edl ? L"EDL (*.edl)\0*.edl\0\0" : L"CSV (*.csv)\0*.csv\0\0",
+			.lpstrFile = buf, .nMaxFile = static_cast<DWORD>(std::size(buf)),
+			.Flags = OFN_OVERWRITEPROMPT | OFN_HIDEREADONLY | OFN_NOCHANGEDIR,
+			.lpstrDefExt = edl ? L"edl" : L"csv",
+		};
+		if (::GetSaveFileNameW(&ofn) == FALSE) return false;
+		path = buf;
+		return true;
+	}
+
+	// the file dialog is shown outside the edit section, so the request is posted first,
+	// and the points are written in a read section.
+	static void request(bool edl)
+	{
+		plugin_window.post_callback(PluginWindow::deferred::export_edit_points, +[](bool edl) static
+		{
+			std::wstring path;
+			if (!pick_file(path, edl)) return;
+
+			std::pair<std::wstring const*, bool> param{ &path, edl };
+			edit_handle->call_read_section_param(&param, [](void* param, EDIT_SECTION* edit) static
+			{
+				auto const& [path, edl] = *static_cast<std::pair<std::wstring const*, bool> const*>(param);
+				uint64_t const t0 = ::GetTickCount64();
+				uint32_t count;
+				bool ok;
+				{
+					buffered_writer out{ *path };
+					if (!out.ok()) {
+						logging::warn(L"Failed to create the file to export.");
+						return;
+					}
+					if (edl) {
+						// the file name without the directory and the extension is the title.
+						std::wstring_view title = *path;
+						title.remove_prefix(title.find_last_of(L"\\/") + 1);
+						title = title.substr(0, title.rfind(L'.'));
+						count = write_edl(edit, out, title);
+					}
+					else count = write_csv(edit, out);
+					out.flush();
+					ok = out.ok();
+				}
+
+				// output an information message.
+				if (ok) logging::info(L"Exported %d edit point(s) in %d ms.", count, static_cast<int>(::GetTickCount64() - t0));
+				else logging::warn(L"Failed to write the exported file.");
+			});
+		}, edl);
+	}
+}
+
+
+////////////////////////////////
+// alignment audit.
+////////////////////////////////
+namespace alignment_audit
+{
+	using edit_point_export::point;
+	using edit_point_export::kind;
+
+	// a cluster of object boundaries on different layers, close to but not exactly on each other.
+	struct finding {
+		int frame_from, frame_until;
+		int layer_a, layer_b; // the first pair found.
+	};
+
+	// finds the near-misses in a run of boundaries, each within `tolerance` frames of the previous one.
+	// a pair on two layers isn't counted if either layer also has a boundary exactly on the other,
+	// so a short object starting on an aligned cut isn't reported.
+	static std::optional<finding> check_cluster(std::span<point const> cluster, int tolerance)
+	{
+		// the boundaries by (layer, frame), for lookups by binary search.
+		std::vector<std::pair<int, int>> boundaries{};
+		boundaries.reserve(cluster.size());
+		for (auto const& p : cluster) boundaries.emplace_back(p.layer, p.frame);
+		std::ranges::sort(boundaries);
+		auto const has_boundary = [&](int layer, int frame)
+		{
+			return std::ranges::binary_search(boundaries, std::pair{ layer, frame });
+		};
+
+		std::optional<finding> ret{};
+		for (size_t i = 0; i < cluster.size(); i++) {
+			for (size_t j = i + 1; j < cluster.size() && cluster[j].frame - cluster[i].frame <= tolerance; j++) {
+				auto const& a = cluster[i]; auto const& b = cluster[j];
+				if (a.layer == b.layer || a.frame == b.frame ||
+					has_boundary(a.layer, b.frame) || has_boundary(b.layer, a.frame)) continue;
+				if (!ret) ret = finding{ a.frame, b.frame, a.layer, b.layer };
+				else ret->frame_until = std::max(ret->frame_until, b.frame);
+			}
+		}
+		return ret;
+	}
+
+	// a single pass over the merged boundaries of all layers, in ascending order.
+	static std::vector<finding> find_near_misses(EDIT_SECTION* edit, int tolerance)
+	{
+		std::vector<finding> ret{};
+		std::vector<point> cluster{};
+		auto const flush = [&]
+		{
+			if (cluster.size() >= 2)
+				if (auto const f = check_cluster(cluster, tolerance)) ret.push_back(*f);
+			cluster.clear();
+		};
+
+		edit_point_export::point_merger points{ edit, true };
+		while (auto const p = points.next()) {
+			if (p->type != kind::object_start && p->type != kind::object_end) continue;
+			if (!cluster.empty() && p->frame - cluster.back().frame > tolerance) flush();
+			cluster.push_back(*p);
+		}
+		flush();
+		return ret;
+	}
+
+	static void audit(EDIT_SECTION* edit)
+	{
+		int const tolerance = settings.audit.tolerance;
+		auto const findings = find_near_misses(edit, tolerance);
+		if (findings.empty()) {
+			logging::info(L"No misaligned boundaries within %d frame(s).", tolerance);
+			return;
+		}
+
+		// output the list, up to a limit.
+		constexpr size_t max_lines = 32;
+		logging::warn(L"Found %d misaligned place(s) within %d frame(s).", static_cast<int>(findings.size()), tolerance);
+		for (auto const& f : findings | std::views::take(max_lines))
+			logging::info(L"  %d - %d F: layer %d and %d.", f.frame_from, f.frame_until, f.layer_a + 1, f.layer_b + 1);
+		if (findings.size() > max_lines)
+			logging::info(L"  ... and %d more.", static_cast<int>(findings.size() - max_lines));
+	}
+
+	// moves to the next or previous finding, searched afresh so edits in between are reflected.
+	static void move_to_finding(EDIT_SECTION* edit, bool forward)
+	{
+		auto const findings = find_near_misses(edit, settings.audit.tolerance);
+		int const frame = edit->info->frame;
+		auto it = std::ranges::partition_point(findings,
+			[&](finding const& f) { return forward ? f.frame_from <= frame : f.frame_from < frame; });
+		if (forward ? it == findings.end() : it == findings.begin()) {
+			logging::info(L"No more misaligned boundaries.");
+			return;
+		}
+		auto const& f = forward ? *it : *(it - 1);
+		move_frame_wrap(edit, f.layer_a, f.frame_from);
+		logging::info(L"Misaligned boundaries at %d - %d F: layer %d and %d.",
+			f.frame_from, f.frame_until, f.layer_a + 1, f.layer_b + 1);
+	}
+}
+
+
+////////////////////////////////
+// mark import.
+////////////////////////////////
+namespace mark_import
+{
+	// how the name of a chapter is escaped in the file.
+	enum class escaping : uint8_t { none, doubled_quotes, backslashes };
+
+	// a chapter in the file. the name refers to the file contents, not copied.
+	struct entry {
+		int frame;
+		std::string_view name;
+		escaping esc;
+	};
+
+	static std::string_view trim(std::string_view s)
+	{
+		constexpr std::string_view spaces = " \t\r\n";
+		size_t const l = s.find_first_not_of(spaces);
+		if (l == s.npos) return {};
+		return s.substr(l, s.find_last_not_of(spaces) + 1 - l);
 	}
-	else {
-		edit->set_mark_frame(frame, nullptr);
-		state = 0;
+	static bool starts_with_ci(std::string_view s, std::string_view prefix)
+	{
+		return s.size() >= prefix.size() && std::ranges::equal(s.substr(0, prefix.size()), prefix,
+			[](char a, char b) { return (a | 0x20) == (b | 0x20); });
+	}
+	static bool equal_ci(std::string_view s, std::string_view t)
+	{
+		return s.size() == t.size() && starts_with_ci(s, t);
+	}
+	static std::string_view unquote(std::string_view s, escaping& esc)
+	{
+		bool const quoted = s.size() >= 2 && s.front() == '"' && s.back() == '"';
+		esc = quoted ? escaping::doubled_quotes : escaping::none;
+		return quoted ? s.substr(1, s.size() - 2) : s;
+	}
+	template<class T>
+	static std::optional<T> parse_number(std::string_view s)
+	{
+		T val;
+		auto const [end, ec] = std::from_chars(s.data(), s.data() + s.size(), val);
+		if (ec != std::errc{} || end != s.data() + s.size()) return std::nullopt;
+		return val;
 	}
 
-	// output an information message.
-	constexpr std::wstring_view pats[] = {
-		L"Created an unnamed mark at %d F.",
-		L"Removed an unnamed mark at %d F.",
-		L"Cannot remove the mark at %d F, because it has a valid name.",
+	// converts times in the file into frames of the scene.
+	struct time_parser {
+		Timeline_calc tl_calc;
+		int fps; // the rounded frame rate, for timecodes.
+
+		int from_seconds(double sec) const
+		{
+			return static_cast<int>(std::round(tl_calc.second_to_frame(sec)));
+		}
+
+		// "[[h:]m:]s[.fff]" in seconds, or "h:m:s:f" as a timecode.
+		// a timecode with ';' in it, such as "h:m:s;f", is drop-frame, for 29.97 or 59.94 fps.
+		std::optional<int> parse(std::string_view s) const
+		{
+			s = trim(s);
+			double fields[4]{};
+			int n = 0;
+			bool drop_frame = false;
+			for (size_t pos = 0; pos != s.npos; n++) {
+				if (n == 4) return std::nullopt;
+				size_t const sep = s.find_first_of(":;", pos);
+				auto const v = parse_number<double>(s.substr(pos, sep - pos));
+				if (!v || !std::isfinite(*v) || *v < 0) return std::nullopt;
+				fields[n] = *v;
+				if (sep != s.npos && s[sep] == ';') drop_frame = true;
+				pos = sep == s.npos ? s.npos : sep + 1;
+			}
+			if (drop_frame && n != 4) return std::nullopt;
+			switch (n) {
+			case 1: return from_seconds(fields[0]);
+			case 2: return from_seconds(fields[0] * 60 + fields[1]);
+			case 3: return from_seconds(fields[0] * 3600 + fields[1] * 60 + fields[2]);
+			case 4:
+			{
+				if (!std::ranges::all_of(fields, [](double v) { return v == std::floor(v) && v < (1 << 20); }))
+					return std::nullopt;
+				int const minutes = static_cast<int>(fields[0]) * 60 + static_cast<int>(fields[1]);
+				int frame = (minutes * 60 + static_cast<int>(fields[2])) * fps + static_cast<int>(fields[3]);
+				if (drop_frame) {
+					// frame numbers 0 and 1 (0 to 3 for 59.94) are skipped every minute except each tenth.
+					if (fps % 30 != 0) return std::nullopt;
+					frame -= fps / 15 * (minutes - minutes / 10);
+				}
+				return frame;
+			}
+			default: return std::nullopt;
+			}
+		}
 	};
-	constexpr size_t len_num = std::wstring_view{ L"-2147483648" }.size();
-	wchar_t buf[std::bit_ceil(std::max({ pats[0].size(), pats[1].size(), pats[2].size(), }) + (len_num - 2) + 1)];
-	auto const len = ::swprintf_s(buf, pats[state].data(), frame);
-	logging::info(buf);
+
+	// calls `f` for each line, without copying.
+	template<class F>
+	static void for_each_line(std::string_view text, F&& f)
+	{
+		while (!text.empty()) {
+			size_t const eol = text.find('\n');
+			f(trim(text.substr(0, eol)));
+			if (eol == text.npos) break;
+			text.remove_prefix(eol + 1);
+		}
+	}
+
+	// cue sheets: "INDEX 01 mm:ss:ff" of each track, with ff in 1/75 seconds, named by its TITLE.
+	static void parse_cue(std::string_view text, time_parser const& tp, std::vector<entry>& out)
+	{
+		bool in_track = false;
+		entry track{};
+		for_each_line(text, [&](std::string_view line)
+		{
+			if (starts_with_ci(line, "TRACK ")) {
+				in_track = true;
+				track = {};
+			}
+			else if (in_track && starts_with_ci(line, "TITLE "))
+				track.name = unquote(trim(line.substr(6)), track.esc);
+			else if (in_track && starts_with_ci(line, "INDEX 01 ")) {
+				auto const t = trim(line.substr(9));
+				auto const mm = parse_number<int>(t.substr(0, t.find(':')));
+				size_t const c1 = t.find(':'), c2 = c1 == t.npos ? t.npos : t.find(':', c1 + 1);
+				if (!mm || c2 == t.npos) return;
+				auto const ss = parse_number<int>(t.substr(c1 + 1, c2 - c1 - 1)), ff = parse_number<int>(t.substr(c2 + 1));
+				if (!ss || !ff) return;
+				track.frame = tp.from_seconds(*mm * 60 + *ss + *ff / 75.0);
+				out.push_back(track);
+			}
+		});
+	}
+
+	// ffmetadata: "[CHAPTER]" sections with TIMEBASE, START and title.
+	// '=', ';', '#' and '\\' in the values are escaped with backslashes.
+	static void parse_ffmetadata(std::string_view text, time_parser const& tp, std::vector<entry>& out)
+	{
+		bool in_chapter = false;
+		int64_t num = 1, den = 1000, start = -1;
+		entry chapter{};
+		auto const flush = [&]
+		{
+			if (in_chapter && start >= 0 && num > 0 && den > 0) {
+				chapter.frame = tp.from_seconds(static_cast<double>(start) * num / den);
+				out.push_back(chapter);
+			}
+			num = 1; den = 1000; start = -1; chapter = {};
+		};
+		for_each_line(text, [&](std::string_view line)
+		{
+			if (line.starts_with('[')) {
+				flush();
+				in_chapter = starts_with_ci(line, "[CHAPTER]");
+				return;
+			}
+			size_t const eq = line.find('=');
+			if (!in_chapter || eq == line.npos) return;
+			auto const key = line.substr(0, eq), val = line.substr(eq + 1);
+			if (starts_with_ci(key, "TIMEBASE") && key.size() == 8) {
+				size_t const slash = val.find('/');
+				num = parse_number<int64_t>(val.substr(0, slash)).value_or(0);
+				den = slash == val.npos ? 0 : parse_number<int64_t>(val.substr(slash + 1)).value_or(0);
+			}
+			else if (starts_with_ci(key, "START") && key.size() == 5)
+				start = parse_number<int64_t>(val).value_or(-1);
+			else if (starts_with_ci(key, "title") && key.size() == 5) {
+				chapter.name = val;
+				chapter.esc = escaping::backslashes;
+			}
+		});
+		flush();
+	}
+
+	// OGM chapters: "CHAPTERnn=hh:mm:ss.sss" and "CHAPTERnnNAME=...".
+	static void parse_ogm(std::string_view text, time_parser const& tp, std::vector<entry>& out)
+	{
+		std::map<int, entry> chapters{};
+		for_each_line(text, [&](std::string_view line)
+		{
+			size_t const eq = line.find('=');
+			if (eq == line.npos || !starts_with_ci(line, "CHAPTER")) return;
+			auto key = line.substr(7, eq - 7);
+			bool const is_name = key.size() > 4 && starts_with_ci(key.substr(key.size() - 4), "NAME");
+			if (is_name) key.remove_suffix(4);
+			auto const num = parse_number<int>(key);
+			if (!num) return;
+			auto& chapter = chapters.try_emplace(*num, entry{ -1, {}, escaping::none }).first->second;
+			if (is_name) chapter.name = line.substr(eq + 1);
+			else chapter.frame = tp.parse(line.substr(eq + 1)).value_or(-1);
+		});
+		for (auto const& [_, chapter] : chapters)
+			if (chapter.frame >= 0) out.push_back(chapter);
+	}
+
+	// splits a line of CSV into the fields, with the quotes of quoted ones left.
+	static std::vector<std::string_view> split_csv(std::string_view line)
+	{
+		constexpr std::string_view separators = ",\t";
+		std::vector<std::string_view> ret{};
+		for (size_t pos = 0; ; ) {
+			size_t end = line.find_first_of(separators, pos);
+			if (size_t const q = line.find_first_not_of(' ', pos); q < line.size() && line[q] == '"') {
+				// the closing quote is the first one not doubled.
+				size_t c = q + 1;
+				while ((c = line.find('"', c)) != line.npos && c + 1 < line.size() && line[c + 1] == '"') c += 2;
+				end = c == line.npos ? line.npos : line.find_first_of(separators, c + 1);
+			}
+			ret.push_back(trim(line.substr(pos, end - pos)));
+			if (end == line.npos) break;
+			pos = end + 1;
+		}
+		return ret;
+	}
+
+	// CSV: the time in the first column and the name in the second, if any.
+	// lines whose first column isn't a time, such as headers, are skipped.
+	// if the header names the first column "frame", as the edit point list of this plugin does,
+	// the first column is in frames, the name is in the "detail" column,
+	// and only the rows of the "mark" type are taken if there is a "type" column.
+	static void parse_csv(std::string_view text, time_parser const& tp, std::vector<entry>& out)
+	{
+		constexpr size_t none = ~size_t{ 0 };
+		bool first = true, by_frame = false;
+		size_t name_col = 1, type_col = none;
+		for_each_line(text, [&](std::string_view line)
+		{
+			if (line.empty()) return;
+			auto const fields = split_csv(line);
+			escaping esc;
+			if (std::exchange(first, false) && equal_ci(unquote(fields[0], esc), "frame")) {
+				by_frame = true;
+				name_col = none;
+				for (size_t i = 1; i < fields.size(); i++) {
+					auto const name = unquote(fields[i], esc);
+					if (equal_ci(name, "type")) type_col = i;
+					else if (equal_ci(name, "detail")) name_col = i;
+				}
+				return;
+			}
+
+			auto const frame = by_frame ? parse_number<int>(fields[0]) : tp.parse(fields[0]);
+			if (!frame) return;
+			if (type_col != none && (type_col >= fields.size() || !equal_ci(fields[type_col], "mark"))) return;
+			entry e{ *frame, {}, escaping::none };
+			if (name_col < fields.size()) e.name = unquote(fields[name_col], e.esc);
+			out.push_back(e);
+		});
+	}
+
+	static std::wstring decode(std::string_view name, escaping esc, UINT code_page)
+	{
+		std::string unescaped{};
+		if (esc == escaping::doubled_quotes && name.find("\"\"") != name.npos) {
+			for (size_t i = 0; i < name.size(); i++) {
+				unescaped += name[i];
+				if (name[i] == '"' && i + 1 < name.size() && name[i + 1] == '"') i++;
+			}
+			name = unescaped;
+		}
+		else if (esc == escaping::backslashes && name.find('\\') != name.npos) {
+			for (size_t i = 0; i < name.size(); i++) {
+				if (name[i] == '\\' && i + 1 < name.size()) i++;
+				unescaped += name[i];
+			}
+			name = unescaped;
+		}
+		std::wstring ret(::MultiByteToWideChar(code_page, 0, name.data(), static_cast<int>(name.size()), nullptr, 0), L'\0');
+		::MultiByteToWideChar(code_page, 0, name.data(), static_cast<int>(name.size()), ret.data(), static_cast<int>(ret.size()));
+		return ret;
+	}
+
+	// adds or renames marks to match the entries, skipping the ones already the same.
+	// with `replace`, marks not in the entries are removed too.
+	static void apply(EDIT_SECTION* edit, std::vector<entry>& entries, UINT code_page, bool replace)
+	{
+		// a frame listed twice takes the first one.
+		std::ranges::stable_sort(entries, {}, &entry::frame);
+		entries.erase(std::unique(entries.begin(), entries.end(),
+			[](entry const& a, entry const& b) { return a.frame == b.frame; }), entries.end());
+
+		auto const marks = collect_mark_points(edit);
+		uint32_t added = 0, renamed = 0, removed = 0, skipped = 0;
+		auto it_mark = marks.begin();
+		auto const remove_until = [&](int frame)
+		{
+			for (; it_mark != marks.end() && *it_mark < frame; it_mark++) {
+				if (!replace) continue;
+				edit->clear_mark_frame(*it_mark);
+				removed++;
+			}
+		};
+		for (auto const& e : entries) {
+			if (e.frame < 0 || e.frame > edit->info->frame_max) { skipped++; continue; }
+			remove_until(e.frame);
+
+			auto const name = decode(e.name, e.esc, code_page);
+			if (it_mark != marks.end() && *it_mark == e.frame) {
+				it_mark++;
+				auto const memo = edit->get_mark_frame_memo(e.frame);
+				if (name == (memo != nullptr ? memo : L"")) continue; // no change.
+				renamed++;
+			}
+			else added++;
+			edit->set_mark_frame(e.frame, name.empty() ? nullptr : name.c_str());
+		}
+		remove_until(std::numeric_limits<int>::max());
+
+		// output an information message.
+		if (skipped > 0)
+			logging::warn(L"Imported marks: %d added, %d renamed, %d removed. (%d out of the scene.)", added, renamed, removed, skipped);
+		else logging::info(L"Imported marks: %d added, %d renamed, %d removed.", added, renamed, removed);
+	}
+
+	static bool pick_file(std::wstring& path)
+	{
+		wchar_t buf[MAX_PATH]{};
+		OPENFILENAMEW ofn{
+			.lStructSize = sizeof(ofn),
+			.hwndOwner = edit_handle->get_host_app_window(),
+			.lpstrFilter = L"Chapters (*.cue;*.txt;*.csv;*.ini)\0*.cue;*.txt;*.csv;*.ini\0All files (*.*)\0*.*\0\0",
+			.lpstrFile = buf, .nMaxFile = static_cast<DWORD>(std::size(buf)),
+			.Flags = OFN_FILEMUSTEXIST | OFN_HIDEREADONLY | OFN_NOCHANGEDIR,
+		};
+		if (::GetOpenFileNameW(&ofn) == FALSE) return false;
+		path = buf;
+		return true;
+	}
+
+	// the file dialog is shown outside the edit section, so the request is posted first,
+	// and the file is parsed and applied in a new edit section.
+	static void request(bool replace)
+	{
+		plugin_window.post_callback(PluginWindow::deferred::import_marks, +[](bool replace) static
+		{
+			std::wstring path;
+			if (!pick_file(path)) return;
+
+			mapped_file const file{ path };
+			if (file.data.empty()) {
+				logging::warn(L"Failed to read the chapter file.");
+				return;
+			}
+
+			// UTF-16 is converted to UTF-8 as a whole. otherwise the file is parsed in place,
+			// as UTF-8 if valid, or in the system code page.
+			std::string_view text{ reinterpret_cast<char const*>(file.data.data()), file.data.size() };
+			std::string converted{};
+			UINT code_page = CP_UTF8;
+			if (text.starts_with("\xff\xfe")) {
+				std::wstring_view const wide{ reinterpret_cast<wchar_t const*>(text.data() + 2), (text.size() - 2) / sizeof(wchar_t) };
+				converted.resize(::WideCharToMultiByte(CP_UTF8, 0, wide.data(), static_cast<int>(wide.size()), nullptr, 0, nullptr, nullptr));
+				::WideCharToMultiByte(CP_UTF8, 0, wide.data(), static_cast<int>(wide.size()), converted.data(), static_cast<int>(converted.size()), nullptr, nullptr);
+				text = converted;
+			}
+			else if (text.starts_with("\xef\xbb\xbf")) text.remove_prefix(3);
+			else if (::MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, text.data(), static_cast<int>(text.size()), nullptr, 0) == 0)
+				code_page = CP_ACP;
+
+			std::tuple<std::string_view, UINT, bool> param{ text, code_page, replace };
+			edit_handle->call_edit_section_param(&param, [](void* param, EDIT_SECTION* edit) static
+			{
+				auto const& [text, code_page, replace] = *static_cast<std::tuple<std::string_view, UINT, bool> const*>(param);
+				time_parser const tp{
+					{ edit->info->rate, edit->info->scale },
+					std::max(1, (edit->info->rate + edit->info->scale / 2) / edit->info->scale),
+				};
+
+				// tell the format from the contents.
+				bool is_cue = false, is_ogm = false, first = true;
+				for_each_line(text, [&](std::string_view line)
+				{
+					if (line.empty()) return;
+					if (first && starts_with_ci(line, "CHAPTER") && line.find('=') != line.npos) is_ogm = true;
+					if (starts_with_ci(line, "INDEX ")) is_cue = true;
+					first = false;
+				});
+
+				std::vector<entry> entries{};
+				if (text.starts_with(";FFMETADATA")) parse_ffmetadata(text, tp, entries);
+				else if (is_cue) parse_cue(text, tp, entries);
+				else if (is_ogm) parse_ogm(text, tp, entries);
+				else parse_csv(text, tp, entries);
+
+				if (entries.empty()) {
+					logging::warn(L"No chapters found in the file.");
+					return;
+				}
+				apply(edit, entries, code_page, replace);
+			});
+		}, replace);
+	}
 }
 
 
 ////////////////////////////////
 // repositioning objects.
 ////////////////////////////////
+static void warn_search_truncated(search_budget<tick_count_clock> const& budget)
+{
+	// tell a truncated search apart from finding no space.
+	if (budget.truncated == search_budget<tick_count_clock>::cause::time)
+		logging::warn(L"Gave up searching for space after %zu rounds, as it took too long.", budget.rounds);
+	else logging::warn(L"Gave up searching for space after %zu rounds, the bound of the search.", budget.rounds);
+}
+
 enum class Direction {
 	Left, Right, Up, Down,
 };
@@ -1960,6 +3876,8 @@ static void move_selected_objects(EDIT_SECTION* edit, Direction dir)
 
 	// then move.
 	uint32_t moved_count = 0, left_behind = 0;
+	bool aborted = false;
+	auto const is_target = [&](OBJECT_HANDLE obj) { return target_set.contains(obj); };
 	int const supposed_current = edit->info->frame + (edit->info->frame == edit->info->frame_max ? 1 : 0);
 	switch (dir) {
 	case Direction::Left:
@@ -1985,25 +3903,13 @@ static void move_selected_objects(EDIT_SECTION* edit, Direction dir)
 		if (offset == 0 && frame_min > 0) {
 			// if no space is found, "jump over" the objects to left
 			// and find the nearest possible space.
-			for (int ofs = 2, prev = ofs; ofs <= frame_min; prev = ofs) {
-				for (auto const& [_, pos] : targets) {
-					for (int f = pos.start - ofs; f <= pos.end - ofs; ) {
-						auto const o = edit->find_object(pos.layer, f);
-						if (o == nullptr) break;
-						auto const p = edit->get_object_layer_frame(o);
-						f = p.end + 1;
-						if (target_set.contains(o)) continue; // ignore target objects.
-						if (std::max(pos.start - ofs, p.start) <= std::min(pos.end - ofs, p.end)) {
-							// objects will overlap. find the next candidate.
-							ofs = pos.end + 1 - p.start;
-							break;
-						}
-					}
-				}
-				if (prev == ofs) {
-					offset = ofs;
-					break;
-				}
+			// `ofs` strictly increases up to `frame_min`, which also bounds the rounds.
+			search_budget<tick_count_clock> budget{
+				jump_over_rounds(edit, targets, is_target, false, static_cast<size_t>(frame_min)) };
+			offset = find_space_left(edit, targets, is_target, frame_min, budget);
+			if (budget.truncated != decltype(budget)::cause::none) {
+				warn_search_truncated(budget);
+				aborted = true;
 			}
 		}
 
@@ -2042,25 +3948,14 @@ static void move_selected_objects(EDIT_SECTION* edit, Direction dir)
 		if (offset == 0) {
 			// if no space is found, "jump over" the objects to right
 			// and find the nearest possible space.
-			for (int ofs = 2, prev = ofs; ; prev = ofs) {
-				for (auto const& [_, pos] : targets) {
-					for (int f = pos.start + ofs; f <= pos.end + ofs; ) {
-						auto const o = edit->find_object(pos.layer, f);
-						if (o == nullptr) break;
-						auto const p = edit->get_object_layer_frame(o);
-						f = p.end + 1;
-						if (target_set.contains(o)) continue; // ignore target objects.
-						if (std::max(pos.start + ofs, p.start) <= std::min(pos.end + ofs, p.end)) {
-							// objects will overlap. find the next candidate.
-							ofs = p.end + 1 - pos.start;
-							// keep searching.
-						}
-					}
-				}
-				if (prev == ofs) {
-					offset = ofs;
-					break;
-				}
+			// `ofs` strictly increases, and no objects lie beyond `frame_max`,
+			// hence also at most `frame_max - frame_min + 2` rounds.
+			search_budget<tick_count_clock> budget{
+				jump_over_rounds(edit, targets, is_target, true, static_cast<size_t>(edit->info->frame_max - frame_min + 2)) };
+			offset = find_space_right(edit, targets, is_target, 2, budget);
+			if (budget.truncated != decltype(budget)::cause::none) {
+				warn_search_truncated(budget);
+				aborted = true;
 			}
 		}
 		else if (offset + frame_min > edit->info->frame_max)
@@ -2128,31 +4023,20 @@ static void move_selected_objects(EDIT_SECTION* edit, Direction dir)
 				auto const [layer, frame, do_move] = calc_scroll_pos(*edit->info, pos);
 				if (do_move) {
 					// scroll in a different edit_section, otherwise infinite loop.
-					plugin_window.post_callback([](auto layer_frame) {
-						edit_handle->call_edit_section_param(&layer_frame, [](void* param, EDIT_SECTION* edit) {
-							uint64_t const& layer_frame = *static_cast<uint64_t*>(param);
-							int32_t const layer = static_cast<int>(layer_frame & 0xffffffff),
-							frame = static_cast<int>((layer_frame >> 32) & 0xffffffff);
-							edit->set_display_layer_frame(layer, frame);
-						});
-					}, static_cast<uint32_t>(layer) | (static_cast<uint64_t>(frame) << 32));
+					post_focus_follow({ .select_layer = -1, .scroll_layer = layer, .scroll_frame = frame, .scroll = true });
 				}
 			}
 		}
 	}
 
+	if (moved_count > 0) invalidate_object_caches();
+
 	// output an information message.
+	if (aborted) return; // already warned.
 	if (moved_count + left_behind > 0) {
-		constexpr std::wstring_view
-			pat1 = L"Moved %d object(s).", pat2 = L" (%d left behind.)";
-		constexpr size_t len_num = std::wstring_view{ L"-2147483648" }.size();
-		wchar_t buf[std::bit_ceil(pat1.size() + pat2.size() + 2 * (len_num - 2) + 1)];
-		auto const len = ::swprintf_s(buf, pat1.data(), moved_count);
-		if (left_behind > 0) {
-			::swprintf_s(buf + len, std::size(buf) - len, pat2.data(), left_behind);
-			logging::warn(buf);
-		}
-		else logging::info(buf);
+		if (left_behind > 0)
+			logging::warn(L"Moved %d object(s). (%d left behind.)", moved_count, left_behind);
+		else logging::info(L"Moved %d object(s).", moved_count);
 	}
 	else logging::info(L"Found no space to move the object(s).");
 }
@@ -2182,97 +4066,512 @@ static void duplicate_object_to_right(EDIT_SECTION* edit)
 		})->first;
 	}
 
-	// check collisions.
-	while (true) {
-		for (auto const& [_, pos] : targets) {
-			auto const other = edit->find_object(pos.layer, pos.start + cand_offset);
-			if (other == nullptr) continue;
-			auto const other_pos = edit->get_object_layer_frame(other);
-			if (other_pos.start <= pos.end + cand_offset) {
-				cand_offset = other_pos.end + 1 - pos.start;
-				goto fail;
+	// check collisions, where the originals are obstacles too.
+	// `cand_offset` strictly increases, and no objects lie beyond `frame_max`,
+	// hence also at most `frame_max + 2` rounds.
+	constexpr auto is_target = [](OBJECT_HANDLE) { return false; };
+	search_budget<tick_count_clock> budget{
+		jump_over_rounds(edit, targets, is_target, true, static_cast<size_t>(edit->info->frame_max + 2)) };
+	cand_offset = find_space_right(edit, targets, is_target, cand_offset, budget);
+	if (budget.truncated != decltype(budget)::cause::none) {
+		warn_search_truncated(budget);
+		return;
+	}
+
+	// duplicate objects with the found offset.
+	for (auto const& [obj, pos] : targets) {
+		std::string const alias = edit->get_object_alias(obj);
+		auto const new_obj = edit->create_object_from_alias(alias.c_str(),
+			pos.layer, pos.start + cand_offset, pos.end - pos.start + 1);
+		if (new_obj != nullptr) invalidate_object_caches();
+
+		// move the focus if the original is focused.
+		if (obj == focused && new_obj != nullptr)
+			change_focus_object(edit, new_obj);
+	}
+}
+
+////////////////////////////////
+// time stretching operations.
+////////////////////////////////
+static int calc_stretched_frame(int frame, double length, EDIT_INFO const* info)
+{
+	switch (settings.stretch.unit) {
+	case Settings::time_unit::second: default:
+		return frame + std::lround(length * info->rate / info->scale);
+	case Settings::time_unit::frame:
+		return frame + std::lround(length);
+	}
+}
+
+static void stretch_selected_objects(EDIT_SECTION* edit, bool forward, int absolute_frame = -1)
+{
+	auto targets = get_selected_objects(edit);
+	if (targets.empty()) return; // no operation.
+
+	// then move the starting and ending positions.
+	uint32_t stretched_count = 0;
+	for (auto const& [obj, pos] : targets) {
+		int const cnt_sections = edit->get_object_section_num(obj);
+
+		// stretch the edge.
+		if (forward) {
+			int new_end = std::max(
+				absolute_frame >= 0 ? absolute_frame :
+				calc_stretched_frame(pos.end + 1, settings.stretch.length, edit->info),
+				cnt_sections <= 1 ? pos.start + 1 :
+				edit->get_object_section_frame(obj, cnt_sections - 1) + 2);
+
+			// hit-test with other objects.
+			auto const [o, s, e] = find_next_obj(edit, pos.layer, pos.end + 2);
+			if (o != nullptr && s < new_end) new_end = s;
+
+			// stretch the end.
+			if (edit->move_object_section(obj, cnt_sections, new_end - 1)) stretched_count++;
+		}
+		else {
+			int new_start = std::max(std::min(
+				absolute_frame >= 0 ? absolute_frame :
+				calc_stretched_frame(pos.start, -settings.stretch.length, edit->info),
+				cnt_sections <= 1 ? pos.end :
+				edit->get_object_section_frame(obj, 1) - 1), 0);
+
+			// hit-test with other objects.
+			auto const [o, s, e] = find_prev_obj(edit, pos.layer, pos.start - 1);
+			if (o != nullptr && e > new_start) new_start = e;
+
+			// stretch the start.
+			if (edit->move_object_section(obj, 0, new_start)) stretched_count++;
+		}
+	}
+
+	if (stretched_count > 0) invalidate_object_caches();
+
+	// output an information message.
+	if (stretched_count > 0) {
+		logging::info(L"Stretched %d object(s).", stretched_count);
+	}
+	else logging::info(L"Found no space to stretch the object(s).");
+}
+
+
+////////////////////////////////
+// ripple operations.
+////////////////////////////////
+static void ripple_shift(EDIT_SECTION* edit, bool insert)
+{
+	int const frame = edit->info->frame;
+	int amount = std::abs(calc_stretched_frame(0, settings.stretch.length, edit->info));
+	if (amount == 0) return; // no operation.
+
+	// collect the objects starting at or after the current frame, layer by layer.
+	// find_object() walks forward, so each list is in ascending order without sorting.
+	struct layer_objects {
+		int layer;
+		int free_from; // the end of the preceding object that stays, plus 1.
+		std::vector<std::pair<OBJECT_HANDLE, int>> objs; // objects and their starts.
+	};
+	std::vector<layer_objects> layers{};
+	for (int layer = 0; layer <= edit->info->layer_max; layer++) {
+		if (edit->get_layer_lock(layer) || is_layer_ignored(edit, layer)) continue;
+
+		layer_objects lo{ .layer = layer, .free_from = -1, .objs = {} };
+		for (int f = frame; ; ) {
+			auto const obj = edit->find_object(layer, f);
+			if (obj == nullptr) break;
+			auto const pos = edit->get_object_layer_frame(obj);
+			f = pos.end + 1;
+			if (pos.start < frame) lo.free_from = pos.end + 1; // crossing the current frame, which stays.
+			else lo.objs.emplace_back(obj, pos.start);
+		}
+		if (lo.objs.empty()) continue;
+		if (lo.free_from < 0) lo.free_from = std::get<2>(find_prev_obj(edit, layer, frame - 1));
+		layers.push_back(std::move(lo));
+	}
+	if (layers.empty()) return; // no operation.
+
+	// shifting left is limited by the free space on every layer.
+	if (!insert) {
+		for (auto const& lo : layers)
+			amount = std::min(amount, lo.objs.front().second - lo.free_from);
+		if (amount <= 0) {
+			logging::info(L"Found no space to shift the object(s).");
+			return;
+		}
+	}
+
+	// move from the far end when shifting right, and from the near end when shifting left,
+	// so each object moves into a space that is already free.
+	uint32_t moved_count = 0, failed_count = 0;
+	auto const move = [&](int layer, auto const& obj_start)
+	{
+		auto const& [obj, start] = obj_start;
+		if (edit->move_object(obj, layer, insert ? start + amount : start - amount)) moved_count++;
+		else failed_count++;
+	};
+	for (auto const& lo : layers) {
+		if (insert) for (auto const& o : lo.objs | std::views::reverse) move(lo.layer, o);
+		else for (auto const& o : lo.objs) move(lo.layer, o);
+	}
+
+	if (moved_count > 0) invalidate_object_caches();
+
+	// output an information message.
+	if (failed_count > 0)
+		logging::warn(L"Shifted %d object(s) by %d frame(s). (%d failed.)", moved_count, insert ? amount : -amount, failed_count);
+	else logging::info(L"Shifted %d object(s) by %d frame(s).", moved_count, insert ? amount : -amount);
+}
+
+static void pack_layers_left(EDIT_SECTION* edit, bool between_marks)
+{
+	// the target layers are those of the selected objects, or the selected layer.
+	std::set<int> target_layers{};
+	for (auto const& [_, pos] : get_selected_objects(edit)) target_layers.insert(pos.layer);
+	if (target_layers.empty()) target_layers.insert(edit->info->layer);
+
+	// the range to pack, [range_start, range_end).
+	int range_start = 0, range_end = std::numeric_limits<int>::max();
+	if (between_marks) {
+		auto const marks = collect_mark_points(edit);
+		range_start = find_neighbor_mark(marks, edit->info->frame + 1, false, edit->info->frame_max);
+		range_end = find_neighbor_mark(marks, edit->info->frame, true, edit->info->frame_max + 1);
+	}
+
+	// a single sweep per layer: each object is placed right after the previous one,
+	// and moving in ascending order never collides as the space on the left is already free.
+	uint32_t moved_count = 0, failed_count = 0;
+	for (int const layer : target_layers) {
+		if (edit->get_layer_lock(layer)) continue;
+
+		int next_start = range_start;
+		for (int f = range_start; f < range_end; ) {
+			auto const obj = edit->find_object(layer, f);
+			if (obj == nullptr) break;
+			auto const pos = edit->get_object_layer_frame(obj);
+			f = pos.end + 1;
+			if (pos.start < range_start) { next_start = pos.end + 1; continue; } // crossing the start, which stays.
+			if (pos.end >= range_end) break; // crossing the end, which stays.
+
+			if (pos.start > next_start) {
+				if (edit->move_object(obj, layer, next_start)) moved_count++;
+				else { failed_count++; next_start = pos.start; }
+			}
+			next_start += pos.end + 1 - pos.start;
+		}
+	}
+
+	if (moved_count > 0) invalidate_object_caches();
+
+	// output an information message.
+	if (failed_count > 0)
+		logging::warn(L"Packed %d object(s). (%d failed.)", moved_count, failed_count);
+	else if (moved_count > 0)
+		logging::info(L"Packed %d object(s).", moved_count);
+	else logging::info(L"Found no gaps to close.");
+}
+
+
+////////////////////////////////
+// cursor history persistence.
+////////////////////////////////
+namespace cursor_history_file
+{
+	// the file consists of a file_header followed by project records,
+	// ordered from the most recently saved one. each project record is:
+	//   project_header, the path (wchar_t x path_len, padded to 4 bytes),
+	//   scene records of: scene_header, cursor_state x count,
+	//   and bookmark records of: bookmark_header, cursor_state x cursor_bookmarks::count.
+	// version 2 had the entries unpacked, which are converted when read.
+	constexpr uint32_t magic = 0x48435754; // "TWCH".
+	constexpr uint32_t version = 3, least_version = 2;
+	constexpr uint32_t max_projects = 32;
+
+	struct file_header { uint32_t magic, version, project_count, reserved; };
+	struct project_header { uint32_t path_len, scene_count, bookmark_count, reserved; };
+	struct scene_header { int32_t scene_id; uint32_t count, position, reserved; };
+	struct bookmark_header { int32_t scene_id; uint32_t valid_bits; };
+	struct cursor_state_v2 { int32_t frame; int16_t layer, view_layer; int32_t view_frame; };
+
+	constexpr size_t padded(size_t len) { return (len + 3) & ~size_t{ 3 }; }
+	constexpr size_t entry_size(uint32_t ver) { return ver < 3 ? sizeof(cursor_state_v2) : sizeof(cursor_state); }
+	constexpr size_t bookmark_size(uint32_t ver) { return sizeof(bookmark_header) + cursor_bookmarks::count * entry_size(ver); }
+
+	// reads `out.size()` entries written in the version `ver`.
+	static void read_entries(std::span<std::byte const> src, uint32_t ver, std::span<cursor_state> out)
+	{
+		if (ver >= 3) {
+			std::memcpy(out.data(), src.data(), out.size_bytes());
+			return;
+		}
+		for (auto& e : out) {
+			cursor_state_v2 v; std::memcpy(&v, src.data(), sizeof(v));
+			src = src.subspan(sizeof(v));
+			e = cursor_state::make(v.layer, v.frame, v.view_layer, v.view_frame);
+		}
+	}
+
+	static std::wstring file_path()
+	{
+		return Settings::plugin_file_path(L".history");
+	}
+
+	// last write time of the file when it was loaded or saved,
+	// to tell whether others, such as another instance of AviUtl2, have written it since.
+	inline uint64_t known_write_time = 0;
+
+	static bool same_path(std::wstring_view const& a, std::wstring_view const& b)
+	{
+		return ::CompareStringOrdinal(a.data(), static_cast<int>(a.size()),
+			b.data(), static_cast<int>(b.size()), TRUE) == CSTR_EQUAL;
+	}
+
+	// bounds-checked sequential reader.
+	struct reader {
+		std::span<std::byte const> data;
+
+		template<class T>
+		bool read(T& v)
+		{
+			if (data.size() < sizeof(T)) return false;
+			std::memcpy(&v, data.data(), sizeof(T));
+			data = data.subspan(sizeof(T));
+			return true;
+		}
+		bool take(size_t len, std::span<std::byte const>& out)
+		{
+			if (data.size() < len) return false;
+			out = data.first(len);
+			data = data.subspan(len);
+			return true;
+		}
+	};
+
+	struct project_record {
+		uint32_t version;
+		std::wstring_view path;
+		uint32_t scene_count, bookmark_count;
+		std::span<std::byte const> scenes; // the scene records, followed by the bookmark records.
+		std::span<std::byte const> raw; // the entire project record.
+	};
+
+	// enumerates the project records. returns false if the file is invalid.
+	static bool parse(std::span<std::byte const> data, std::vector<project_record>& records)
+	{
+		reader r{ data };
+		file_header fh;
+		if (!r.read(fh) || fh.magic != magic || fh.version < least_version || fh.version > version) return false;
+		for (uint32_t i = 0; i < fh.project_count; i++) {
+			auto const start = r.data;
+			project_header ph; std::span<std::byte const> path;
+			if (!r.read(ph) || !r.take(padded(size_t{ ph.path_len } * sizeof(wchar_t)), path)) return false;
+			auto const scenes = r.data;
+			for (uint32_t j = 0; j < ph.scene_count; j++) {
+				scene_header sh; std::span<std::byte const> body;
+				if (!r.read(sh) || !r.take(sh.count * entry_size(fh.version), body)) return false;
 			}
+			if (std::span<std::byte const> body;
+				!r.take(ph.bookmark_count * bookmark_size(fh.version), body)) return false;
+			records.push_back({
+				.version = fh.version,
+				.path = { reinterpret_cast<wchar_t const*>(path.data()), ph.path_len },
+				.scene_count = ph.scene_count,
+				.bookmark_count = ph.bookmark_count,
+				.scenes = scenes.first(scenes.size() - r.data.size()),
+				.raw = start.first(start.size() - r.data.size()),
+			});
 		}
-		break;
-	fail:
+		return true;
 	}
 
-	// duplicate objects with the found offset.
-	for (auto const& [obj, pos] : targets) {
-		std::string const alias = edit->get_object_alias(obj);
-		auto const new_obj = edit->create_object_from_alias(alias.c_str(),
-			pos.layer, pos.start + cand_offset, pos.end - pos.start + 1);
-
-		// move the focus if the original is focused.
-		if (obj == focused && new_obj != nullptr)
-			edit->set_focus_object(new_obj);
+	// enumerates the contents of a project record, which is already validated by parse().
+	template<class SceneF, class BookmarkF>
+	static void decode(project_record const& record, SceneF&& on_scene, BookmarkF&& on_bookmark)
+	{
+		reader r{ record.scenes };
+		std::vector<cursor_state> entries{};
+		for (uint32_t j = 0; j < record.scene_count; j++) {
+			scene_header sh; std::span<std::byte const> body;
+			r.read(sh); r.take(sh.count * entry_size(record.version), body);
+			entries.resize(sh.count);
+			read_entries(body, record.version, entries);
+			on_scene(sh, std::span<cursor_state const>{ entries });
+		}
+		for (uint32_t j = 0; j < record.bookmark_count; j++) {
+			bookmark_header bh; std::span<std::byte const> body;
+			r.read(bh); r.take(cursor_bookmarks::count * entry_size(record.version), body);
+			cursor_bookmarks b{ .valid_bits = bh.valid_bits };
+			read_entries(body, record.version, b.regs);
+			on_bookmark(bh.scene_id, b);
+		}
 	}
-}
 
-////////////////////////////////
-// time stretching operations.
-////////////////////////////////
-static int calc_stretched_frame(int frame, double length, EDIT_INFO const* info)
-{
-	switch (settings.stretch.unit) {
-	case Settings::time_unit::second: default:
-		return frame + std::lround(length * info->rate / info->scale);
-	case Settings::time_unit::frame:
-		return frame + std::lround(length);
+	static void load(std::wstring_view const& project_path, cursor_undo_bundle& bundle,
+		std::unordered_map<int, cursor_bookmarks>& bookmarks)
+	{
+		auto const path = file_path();
+		known_write_time = ini_file::last_write_time(path);
+		if (project_path.empty()) return;
+
+		mapped_file const file{ path };
+		std::vector<project_record> records{};
+		if (!parse(file.data, records)) return;
+		for (auto const& record : records) {
+			if (!same_path(record.path, project_path)) continue;
+
+			// restore the histories of each scene, and the bookmarks.
+			decode(record,
+				[&](scene_header const& sh, std::span<cursor_state const> entries)
+				{
+					bundle.restore(sh.scene_id).assign(entries, sh.position);
+				},
+				[&](int scene_id, cursor_bookmarks const& b) { bookmarks[scene_id] = b; });
+
+			// logging.
+			logging::verbose(L"Cursor history restored.");
+			return;
+		}
 	}
-}
 
-static void stretch_selected_objects(EDIT_SECTION* edit, bool forward, int absolute_frame = -1)
-{
-	auto targets = get_selected_objects(edit);
-	if (targets.empty()) return; // no operation.
+	// takes the scenes and bookmarks of this project that were saved by others
+	// and aren't in memory. the ones in memory are newer and kept as they are.
+	static void merge(project_record const& record, cursor_undo_bundle& bundle,
+		std::unordered_map<int, cursor_bookmarks>& bookmarks)
+	{
+		size_t scenes = 0, regs = 0;
+		decode(record,
+			[&](scene_header const& sh, std::span<cursor_state const> entries)
+			{
+				if (bundle.contains(sh.scene_id)) return;
+				bundle.restore(sh.scene_id).assign(entries, sh.position);
+				scenes++;
+			},
+			[&](int scene_id, cursor_bookmarks const& b)
+			{
+				auto& dst = bookmarks[scene_id];
+				for (size_t i = 0; i < cursor_bookmarks::count; i++) {
+					if (!b.has(i) || dst.has(i)) continue;
+					dst.regs[i] = b.regs[i];
+					dst.valid_bits |= 1u << i;
+					regs++;
+				}
+			});
 
-	// then move the starting and ending positions.
-	uint32_t stretched_count = 0;
-	for (auto const& [obj, pos] : targets) {
-		int const cnt_sections = edit->get_object_section_num(obj);
+		// logging.
+		logging::info(L"Cursor history file was modified outside. Merged %zu scene(s) and %zu bookmark(s).",
+			scenes, regs);
+	}
 
-		// stretch the edge.
-		if (forward) {
-			int new_end = std::max(
-				absolute_frame >= 0 ? absolute_frame :
-				calc_stretched_frame(pos.end + 1, settings.stretch.length, edit->info),
-				cnt_sections <= 1 ? pos.start + 1 :
-				edit->get_object_section_frame(obj, cnt_sections - 1) + 2);
+	static void save(std::wstring_view const& project_path, cursor_undo_bundle& bundle,
+		std::unordered_map<int, cursor_bookmarks>& bookmarks)
+	{
+		if (project_path.empty()) return;
 
-			// hit-test with other objects.
-			auto const [o, s, e] = find_next_obj(edit, pos.layer, pos.end + 2);
-			if (o != nullptr && s < new_end) new_end = s;
+		std::vector<std::byte> buf{}, others{};
+		auto const append = [](std::vector<std::byte>& dst, void const* p, size_t len)
+		{
+			auto const b = static_cast<std::byte const*>(p);
+			dst.insert(dst.end(), b, b + len);
+		};
+		auto const write = [&](void const* p, size_t len) { append(buf, p, len); };
+		auto const write_other = [&](void const* p, size_t len) { append(others, p, len); };
+		auto const path = file_path();
 
-			// stretch the end.
-			if (edit->move_object_section(obj, cnt_sections, new_end - 1)) stretched_count++;
-		}
-		else {
-			int new_start = std::max(std::min(
-				absolute_frame >= 0 ? absolute_frame :
-				calc_stretched_frame(pos.start, -settings.stretch.length, edit->info),
-				cnt_sections <= 1 ? pos.end :
-				edit->get_object_section_frame(obj, 1) - 1), 0);
+		// read the current file first, as others may have written it since it was loaded.
+		// the records of other projects are kept as they are.
+		uint32_t other_count = 0;
+		{
+			mapped_file const file{ path };
+			std::vector<project_record> records{};
+			parse(file.data, records);
+			bool const modified = known_write_time != ini_file::last_write_time(path);
+			for (auto const& record : records) {
+				if (same_path(record.path, project_path)) {
+					if (modified) merge(record, bundle, bookmarks);
+					continue;
+				}
+				if (other_count >= max_projects - 1) continue;
+				other_count++;
+				if (record.version == version) {
+					write_other(record.raw.data(), record.raw.size());
+					continue;
+				}
 
-			// hit-test with other objects.
-			auto const [o, s, e] = find_prev_obj(edit, pos.layer, pos.start - 1);
-			if (o != nullptr && e > new_start) new_start = e;
+				// convert from the older version.
+				project_header const ph{
+					.path_len = static_cast<uint32_t>(record.path.size()),
+					.scene_count = record.scene_count,
+					.bookmark_count = record.bookmark_count,
+					.reserved = 0,
+				};
+				write_other(&ph, sizeof(ph));
+				write_other(record.path.data(), record.path.size() * sizeof(wchar_t));
+				others.resize(padded(others.size()));
+				decode(record,
+					[&](scene_header const& sh, std::span<cursor_state const> entries)
+					{
+						write_other(&sh, sizeof(sh));
+						write_other(entries.data(), entries.size_bytes());
+					},
+					[&](int scene_id, cursor_bookmarks const& b)
+					{
+						bookmark_header const bh{ .scene_id = scene_id, .valid_bits = b.valid_bits };
+						write_other(&bh, sizeof(bh));
+						write_other(b.regs.data(), sizeof(b.regs));
+					});
+			}
+		}
 
-			// stretch the start.
-			if (edit->move_object_section(obj, 0, new_start)) stretched_count++;
+		// the record of this project comes first.
+		file_header const fh{ .magic = magic, .version = version, .project_count = 1 + other_count, .reserved = 0 };
+		write(&fh, sizeof(fh));
+		project_header ph{
+			.path_len = static_cast<uint32_t>(project_path.size()),
+			.scene_count = 0,
+			.bookmark_count = static_cast<uint32_t>(bookmarks.size()),
+			.reserved = 0,
+		};
+		bundle.for_each([&](int, auto const&) { ph.scene_count++; });
+		write(&ph, sizeof(ph));
+		write(project_path.data(), project_path.size() * sizeof(wchar_t));
+		buf.resize(padded(buf.size()));
+		bundle.for_each([&](int scene_id, undo_history<cursor_state> const& history)
+		{
+			auto const entries = history.entries();
+			scene_header const sh{
+				.scene_id = scene_id,
+				.count = static_cast<uint32_t>(entries.size()),
+				.position = static_cast<uint32_t>(history.position()),
+				.reserved = 0,
+			};
+			write(&sh, sizeof(sh));
+			write(entries.data(), entries.size() * sizeof(cursor_state));
+		});
+		for (auto const& [scene_id, b] : bookmarks) {
+			bookmark_header const bh{ .scene_id = scene_id, .valid_bits = b.valid_bits };
+			write(&bh, sizeof(bh));
+			write(b.regs.data(), sizeof(b.regs));
 		}
-	}
+		buf.insert(buf.end(), others.begin(), others.end());
+
+		// write to a temporary file, and then replace the old one.
+		auto const tmp_path = path + L".tmp";
+		bool success = false;
+		if (HANDLE const h = ::CreateFileW(tmp_path.c_str(), GENERIC_WRITE, 0, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr); h != INVALID_HANDLE_VALUE) {
+			DWORD written = 0;
+			success = ::WriteFile(h, buf.data(), static_cast<DWORD>(buf.size()), &written, nullptr) != FALSE
+				&& written == buf.size();
+			::CloseHandle(h);
+		}
+		if (success)
+			success = ::MoveFileExW(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+		else ::DeleteFileW(tmp_path.c_str());
+		if (success) known_write_time = ini_file::last_write_time(path);
 
-	// output an information message.
-	if (stretched_count > 0) {
-		constexpr std::wstring_view
-			pat = L"Stretched %d object(s).";
-		constexpr size_t len_num = std::wstring_view{ L"-2147483648" }.size();
-		wchar_t buf[std::bit_ceil(pat.size() + (len_num - 2) + 1)];
-		auto const len = ::swprintf_s(buf, pat.data(), stretched_count);
-		logging::info(buf);
+		// logging.
+		if (success) logging::verbose(L"Cursor history saved.");
+		else logging::warn(L"Failed to save the cursor history.");
 	}
-	else logging::info(L"Found no space to stretch the object(s).");
 }
 
 
@@ -2281,45 +4580,106 @@ static void stretch_selected_objects(EDIT_SECTION* edit, bool forward, int absol
 ////////////////////////////////
 namespace cursor_undo
 {
-	static void on_load_project()
+	// path of the current project, used as the key of the saved history.
+	inline std::wstring project_path{};
+
+	// suspends polling during playback, checking periodically whether it has settled.
+	inline cursor_poller<int, cursor_state, tick_count_clock> poller{ cursor_undo_queues };
+	constexpr UINT settle_check_interval = 150; // in milliseconds.
+	constexpr UINT_PTR settle_timer_id = 1;
+
+	static void end_playback()
+	{
+		if (poller.end()) ::KillTimer(plugin_window.root, settle_timer_id);
+	}
+
+	static void CALLBACK on_settle_check(HWND, UINT, UINT_PTR, DWORD)
 	{
+		if (!poller.check_settled([] { return cursor_state::from(get_edit_info()); })) return;
+
+		::KillTimer(plugin_window.root, settle_timer_id);
+		logging::verbose(L"Cursor undo polling resumed.");
+	}
+
+	static void save_history()
+	{
+		cursor_history_file::save(project_path, cursor_undo_queues, cursor_bookmark_table);
+		cursor_undo_queues.set_extra_memory(cursor_bookmark_table.size() * sizeof(cursor_bookmarks)); // may have been merged.
+	}
+
+	static void on_load_project(PROJECT_FILE* project)
+	{
+		// keep the history of the previous project.
+		end_playback();
+		save_history();
+
 		// clear the queue.
 		cursor_undo_queues.clear();
+		cursor_bookmark_table.clear();
 		logging::verbose(L"Cursor undo buffer cleared.");
+
+		// restore the saved history of this project.
+		auto const path = project->get_project_file_path();
+		project_path = path != nullptr ? path : L"";
+		cursor_history_file::load(project_path, cursor_undo_queues, cursor_bookmark_table);
+		cursor_undo_queues.set_extra_memory(cursor_bookmark_table.size() * sizeof(cursor_bookmarks));
+	}
+
+	static void on_save_project(PROJECT_FILE* project)
+	{
+		// the path may have changed by "save as".
+		auto const path = project->get_project_file_path();
+		project_path = path != nullptr ? path : L"";
+		save_history();
 	}
 
 	static void on_scene_changed()
 	{
 		// prepare the undo history for this scene, if not created yet.
 		auto const info = get_edit_info();
-		cursor_undo_queues.set_key(info.scene_id, info.frame);
+		cursor_undo_queues.set_key(info.scene_id, cursor_state::from(info));
 		cursor_undo_queues.reset_cooltime();
 	}
 
 	static void on_frame_changed()
 	{
-		// suppress polling for a certain amount of time.
-		if (cursor_undo_queues.check_cooltime()) return;
+		if (poller.on_frame_changed([] { return cursor_state::from(get_edit_info()); })
+			!= decltype(poller)::result::playback_begun) return;
 
-		// update the history.
-		if (auto* queue = cursor_undo_queues.current(); queue != nullptr)
-			queue->check_forward(get_edit_info().frame);
+		::SetTimer(plugin_window.root, settle_timer_id, settle_check_interval, &on_settle_check);
+		logging::verbose(L"Cursor undo polling suspended during playback.");
 	}
 
 	static void on_update_object()
 	{
-		if (auto* queue = cursor_undo_queues.current(); queue != nullptr) {
-			queue->check_forward(get_edit_info().frame);
+		if (cursor_undo_queues.current() != nullptr) {
+			cursor_undo_queues.check_forward(cursor_state::from(get_edit_info()));
 			cursor_undo_queues.reset_cooltime();
 		}
 	}
 
+	static void restore(EDIT_SECTION* edit, cursor_state const& state)
+	{
+		// restore the cursor and the scroll position in the same edit section.
+		// the view is recorded before the move that left it, so it may not contain the cursor.
+		// in that case, scroll from there just enough to show it.
+		EDIT_INFO view = *edit->info;
+		view.display_layer_start = state.view_layer();
+		view.display_frame_start = state.view_frame();
+		auto const [view_layer, view_frame, _] = calc_scroll_pos(view,
+			{ .layer = state.layer, .start = state.frame, .end = state.frame });
+		bool const scroll = view_layer != edit->info->display_layer_start
+			|| view_frame != edit->info->display_frame_start;
+		move_frame_wrap(edit, state.layer, state.frame);
+		if (scroll) edit->set_display_layer_frame(view_layer, view_frame);
+	}
+
 	static void undo(EDIT_SECTION* edit)
 	{
 		if (auto* queue = cursor_undo_queues.current(); queue != nullptr) {
 			if (queue->size() <= 1) return;
-			queue->check_forward(get_edit_info().frame); // push the current as a redo target.
-			move_frame_wrap(edit, edit->info->layer, queue->backward());
+			cursor_undo_queues.check_forward(cursor_state::from(*edit->info)); // push the current as a redo target.
+			restore(edit, queue->backward());
 			cursor_undo_queues.reset_cooltime();
 		}
 	}
@@ -2327,15 +4687,45 @@ namespace cursor_undo
 	static void redo(EDIT_SECTION* edit)
 	{
 		if (auto* queue = cursor_undo_queues.current(); queue != nullptr) {
-			queue->check_forward(edit->info->frame);
-			if (int next_frame; queue->repush(next_frame)) {
-				move_frame_wrap(edit, edit->info->layer, next_frame);
+			cursor_undo_queues.check_forward(cursor_state::from(*edit->info));
+			if (cursor_state next; queue->repush(next)) {
+				restore(edit, next);
 				cursor_undo_queues.reset_cooltime();
 			}
 		}
 	}
 }
 
+////////////////////////////////
+// cursor bookmarks.
+////////////////////////////////
+namespace cursor_bookmark
+{
+	static void set(EDIT_SECTION* edit, size_t index)
+	{
+		auto const [it, inserted] = cursor_bookmark_table.try_emplace(edit->info->scene_id);
+		if (inserted) cursor_undo_queues.set_extra_memory(cursor_bookmark_table.size() * sizeof(cursor_bookmarks));
+		auto& b = it->second;
+		b.regs[index] = cursor_state::from(*edit->info);
+		b.valid_bits |= 1u << index;
+
+		// logging.
+		logging::verbose(L"Bookmark '%c' set at frame %d, layer %d.",
+			static_cast<wchar_t>(L'a' + index), edit->info->frame, edit->info->layer + 1);
+	}
+
+	static void jump(EDIT_SECTION* edit, size_t index)
+	{
+		auto const it = cursor_bookmark_table.find(edit->info->scene_id);
+		if (it == cursor_bookmark_table.end() || !it->second.has(index)) return; // not set.
+
+		// make the current position undoable.
+		cursor_undo_queues.check_forward(cursor_state::from(*edit->info));
+		cursor_undo::restore(edit, it->second.regs[index]);
+		cursor_undo_queues.reset_cooltime();
+	}
+}
+
 ////////////////////////////////
 // layer operations.
 ////////////////////////////////
@@ -2352,11 +4742,13 @@ static void toggle_layer_enable(EDIT_SECTION* edit)
 	}
 	for (auto& [layer, _] : targets)
 		edit->set_layer_enable(layer, result_state);
+	boundary_prefetch::invalidate();
 }
 
 static void follow_focus()
 {
-	if (!settings.navigation.layer_follows_focus && settings.navigation.scroll_follows_focus) return;
+	bool const expected = std::exchange(focus_cache.expected, false);
+	if (!settings.navigation.layer_follows_focus && !settings.navigation.scroll_follows_focus) return;
 
 	// as changing the selected layer causes an extra rendering, suppress it if possible.
 	// retrieve the current state.
@@ -2366,14 +4758,35 @@ static void follow_focus()
 		.start = curr_info.display_frame_start,
 		.end = curr_info.display_frame_start + curr_info.display_frame_num - 1,
 	};
-	edit_handle->call_read_section_param(&target, [](void* p_ret, EDIT_SECTION* edit) static
-	{
-		// retrieve the layer of the focused object.
-		auto const obj = edit->get_focus_object();
-		if (obj == nullptr) return;
-		auto& ret = *static_cast<OBJECT_LAYER_FRAME*>(p_ret);
-		ret = edit->get_object_layer_frame(obj);
-	});
+	if (expected && focus_cache.valid) {
+		// the focus was changed by this plugin, and its position is already known.
+		if (focus_cache.obj != nullptr) target = focus_cache.pos;
+
+	#if _DEBUG
+		// verify the cached position against the host.
+		OBJECT_LAYER_FRAME direct = target;
+		edit_handle->call_read_section_param(&direct, [](void* p_ret, EDIT_SECTION* edit) static
+		{
+			if (auto const obj = edit->get_focus_object(); obj != nullptr)
+				*static_cast<OBJECT_LAYER_FRAME*>(p_ret) = edit->get_object_layer_frame(obj);
+		});
+		if (direct.layer != target.layer || direct.start != target.start || direct.end != target.end) {
+			logging::warn(L"Focus cache mismatch: cached (%d, %d-%d), direct (%d, %d-%d).",
+				target.layer, target.start, target.end, direct.layer, direct.start, direct.end);
+			target = direct;
+		}
+	#endif
+	}
+	else {
+		edit_handle->call_read_section_param(&target, [](void* p_ret, EDIT_SECTION* edit) static
+		{
+			// retrieve the layer of the focused object.
+			auto const obj = edit->get_focus_object();
+			if (obj == nullptr) return;
+			auto& ret = *static_cast<OBJECT_LAYER_FRAME*>(p_ret);
+			ret = edit->get_object_layer_frame(obj);
+		});
+	}
 
 	// check if edit_section is required.
 	int select_layer = curr_info.layer;
@@ -2387,24 +4800,12 @@ static void follow_focus()
 	if (select_layer == curr_info.layer && !std::get<2>(scroll_pos)) return;
 
 	// cannot skip the edit_section.
-	// as call_edit_section() cannot be called within this callback, post a window message callback to call it.
-	struct data {
-		int select_layer;
-		decltype(scroll_pos) scroll_pos;
-	};
-	auto data_ptr = std::make_unique<data>(select_layer, scroll_pos);
-	plugin_window.post_callback([](auto pointer) static
-	{
-		std::unique_ptr<data> ptr{ reinterpret_cast<data*>(pointer) };
-		edit_handle->call_edit_section_param(ptr.get(), [](void* pointer, EDIT_SECTION* edit) static
-		{
-			auto const& ptr = reinterpret_cast<data*>(pointer);
-			if (ptr->select_layer != edit->info->layer)
-				edit->set_cursor_layer_frame(ptr->select_layer, edit->info->frame);
-			if (std::get<2>(ptr->scroll_pos))
-				edit->set_display_layer_frame(std::get<0>(ptr->scroll_pos), std::get<1>(ptr->scroll_pos));
-		});
-	}, reinterpret_cast<uintptr_t>(data_ptr.release()));
+	post_focus_follow({
+		.select_layer = select_layer,
+		.scroll_layer = std::get<0>(scroll_pos),
+		.scroll_frame = std::get<1>(scroll_pos),
+		.scroll = std::get<2>(scroll_pos),
+	});
 }
 
 
@@ -2413,12 +4814,21 @@ static void follow_focus()
 ////////////////////////////////
 static void on_load_project(PROJECT_FILE* project)
 {
-	cursor_undo::on_load_project();
+	focus_cache.valid = false;
+	cursor_undo::on_load_project(project);
+	boundary_prefetch::invalidate();
+}
+
+static void on_save_project(PROJECT_FILE* project)
+{
+	cursor_undo::on_save_project(project);
 }
 
 static void on_scene_changed(void* param)
 {
+	focus_cache.valid = false;
 	cursor_undo::on_scene_changed();
+	boundary_prefetch::invalidate();
 }
 
 static void on_frame_changed(void* param)
@@ -2428,7 +4838,9 @@ static void on_frame_changed(void* param)
 
 static void on_update_object(void* param)
 {
+	focus_cache.valid = false;
 	cursor_undo::on_update_object();
+	boundary_prefetch::invalidate();
 }
 
 static void on_change_focus_object(void* param)
@@ -2656,7 +5068,7 @@ constexpr struct {
 	},
 	{ L"オブジェクトの選択を解除", [](EDIT_SECTION* edit)
 	{
-		edit->set_focus_object(nullptr);
+		change_focus_object(edit, nullptr);
 	}
 	},
 
@@ -2728,6 +5140,23 @@ constexpr struct {
 	}
 	},
 	{ L"最寄りの小節線を現在フレームに(BPM)", &shift_bpm_grid_nearest_measure_to_cursor },
+	{ L"選択オブジェクトを小節線に揃える(BPM)", [](EDIT_SECTION* edit)
+	{
+		quantize_selected_objects(edit, 1, true);
+	}
+	},
+	{ L"選択オブジェクトを拍数線に揃える(BPM)", [](EDIT_SECTION* edit)
+	{
+		quantize_selected_objects(edit, 1, false);
+	}
+	},
+	{ L"選択オブジェクトを1/N拍に揃える(BPM)", [](EDIT_SECTION* edit)
+	{
+		quantize_selected_objects(edit, settings.search.bpm_grid_div, false);
+	}
+	},
+	{ L"BPMグリッドを編集点に合わせる(BPM)", &fit_bpm_grid_to_edit_points },
+	{ L"タップテンポ(BPM)", &tap_tempo::tap },
 
 	// object moving menu items.
 	{ L"左に選択オブジェクトを詰める", [](EDIT_SECTION* edit)
@@ -2773,6 +5202,28 @@ constexpr struct {
 	}
 	},
 
+	// ripple menu items.
+	{ L"現在フレーム以降を右へずらす", [](EDIT_SECTION* edit)
+	{
+		ripple_shift(edit, true);
+	}
+	},
+	{ L"現在フレーム以降を左へ詰める", [](EDIT_SECTION* edit)
+	{
+		ripple_shift(edit, false);
+	}
+	},
+	{ L"レイヤーの隙間を詰める", [](EDIT_SECTION* edit)
+	{
+		pack_layers_left(edit, false);
+	}
+	},
+	{ L"マーク間の隙間を詰める", [](EDIT_SECTION* edit)
+	{
+		pack_layers_left(edit, true);
+	}
+	},
+
 	// object duplication menu items.
 	{ L"オブジェクトを右へ複製", &duplicate_object_to_right },
 
@@ -2781,10 +5232,138 @@ constexpr struct {
 
 	// anonymous mark shortcut.
 	{ L"無名マークを追加/削除", &toggle_unnamed_mark },
+	{ L"マーク間の小節線にマークを作成(BPM)", [](EDIT_SECTION* edit)
+	{
+		create_marks_on_bpm_grid(edit, true, false);
+	}
+	},
+	{ L"マーク間の拍数線にマークを作成(BPM)", [](EDIT_SECTION* edit)
+	{
+		create_marks_on_bpm_grid(edit, false, false);
+	}
+	},
+	{ L"表示範囲の小節線にマークを作成(BPM)", [](EDIT_SECTION* edit)
+	{
+		create_marks_on_bpm_grid(edit, true, true);
+	}
+	},
+	{ L"表示範囲の拍数線にマークを作成(BPM)", [](EDIT_SECTION* edit)
+	{
+		create_marks_on_bpm_grid(edit, false, true);
+	}
+	},
+
+	// onset detection menu items.
+	{ L"音声ファイルからマークを作成", [](EDIT_SECTION*)
+	{
+		onset_detection::request(false);
+	}
+	},
+	{ L"音声ファイルからBPMグリッドを推定(BPM)", [](EDIT_SECTION*)
+	{
+		onset_detection::request(true);
+	}
+	},
+
+	// edit point export menu items.
+	{ L"編集点をCSVに書き出す", [](EDIT_SECTION*)
+	{
+		edit_point_export::request(false);
+	}
+	},
+	{ L"編集点をEDLに書き出す", [](EDIT_SECTION*)
+	{
+		edit_point_export::request(true);
+	}
+	},
+
+	// mark import menu items.
+	{ L"チャプターファイルからマークを読み込む", [](EDIT_SECTION*)
+	{
+		mark_import::request(false);
+	}
+	},
+	{ L"チャプターファイルでマークを置き換える", [](EDIT_SECTION*)
+	{
+		mark_import::request(true);
+	}
+	},
+
+	// alignment audit menu items.
+	{ L"編集点のずれを検査", &alignment_audit::audit },
+	{ L"左の編集点のずれへ移動", [](EDIT_SECTION* edit)
+	{
+		alignment_audit::move_to_finding(edit, false);
+	}
+	},
+	{ L"右の編集点のずれへ移動", [](EDIT_SECTION* edit)
+	{
+		alignment_audit::move_to_finding(edit, true);
+	}
+	},
 
 	// cursor undo menu items.
 	{ L"カーソル位置を元に戻す", &cursor_undo::undo },
 	{ L"カーソル位置をやり直す", &cursor_undo::redo },
+
+	// cursor bookmark menu items.
+	{ L"ブックマークを設定 (a)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 0); } },
+	{ L"ブックマークを設定 (b)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 1); } },
+	{ L"ブックマークを設定 (c)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 2); } },
+	{ L"ブックマークを設定 (d)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 3); } },
+	{ L"ブックマークを設定 (e)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 4); } },
+	{ L"ブックマークを設定 (f)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 5); } },
+	{ L"ブックマークを設定 (g)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 6); } },
+	{ L"ブックマークを設定 (h)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 7); } },
+	{ L"ブックマークを設定 (i)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 8); } },
+	{ L"ブックマークを設定 (j)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 9); } },
+	{ L"ブックマークを設定 (k)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 10); } },
+	{ L"ブックマークを設定 (l)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 11); } },
+	{ L"ブックマークを設定 (m)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 12); } },
+	{ L"ブックマークを設定 (n)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 13); } },
+	{ L"ブックマークを設定 (o)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 14); } },
+	{ L"ブックマークを設定 (p)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 15); } },
+	{ L"ブックマークを設定 (q)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 16); } },
+	{ L"ブックマークを設定 (r)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 17); } },
+	{ L"ブックマークを設定 (s)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 18); } },
+	{ L"ブックマークを設定 (t)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 19); } },
+	{ L"ブックマークを設定 (u)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 20); } },
+	{ L"ブックマークを設定 (v)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 21); } },
+	{ L"ブックマークを設定 (w)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 22); } },
+	{ L"ブックマークを設定 (x)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 23); } },
+	{ L"ブックマークを設定 (y)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 24); } },
+	{ L"ブックマークを設定 (z)", [](EDIT_SECTION* edit) { cursor_bookmark::set(edit, 25); } },
+	{ L"ブックマークへ移動 (a)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 0); } },
+	{ L"ブックマークへ移動 (b)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 1); } },
+	{ L"ブックマークへ移動 (c)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 2); } },
+	{ L"ブックマークへ移動 (d)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 3); } },
+	{ L"ブックマークへ移動 (e)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 4); } },
+	{ L"ブックマークへ移動 (f)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 5); } },
+	{ L"ブックマークへ移動 (g)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 6); } },
+	{ L"ブックマークへ移動 (h)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 7); } },
+	{ L"ブックマークへ移動 (i)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 8); } },
+	{ L"ブックマークへ移動 (j)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 9); } },
+	{ L"ブックマークへ移動 (k)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 10); } },
+	{ L"ブックマークへ移動 (l)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 11); } },
+	{ L"ブックマークへ移動 (m)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 12); } },
+	{ L"ブックマークへ移動 (n)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 13); } },
+	{ L"ブックマークへ移動 (o)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 14); } },
+	{ L"ブックマークへ移動 (p)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 15); } },
+	{ L"ブックマークへ移動 (q)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 16); } },
+	{ L"ブックマークへ移動 (r)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 17); } },
+	{ L"ブックマークへ移動 (s)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 18); } },
+	{ L"ブックマークへ移動 (t)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 19); } },
+	{ L"ブックマークへ移動 (u)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 20); } },
+	{ L"ブックマークへ移動 (v)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 21); } },
+	{ L"ブックマークへ移動 (w)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 22); } },
+	{ L"ブックマークへ移動 (x)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 23); } },
+	{ L"ブックマークへ移動 (y)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 24); } },
+	{ L"ブックマークへ移動 (z)", [](EDIT_SECTION* edit) { cursor_bookmark::jump(edit, 25); } },
+
+#if _DEBUG
+	// debugging menu items.
+	{ L"[debug] 境界キャッシュの検証", &boundary_prefetch::self_test },
+#endif
 },
 obj_menu_items[] = {
 	// object moving menu items.
@@ -2821,6 +5400,18 @@ obj_menu_items[] = {
 	}
 	},
 
+	// gap closing menu items.
+	{ L"レイヤーの隙間を詰める", [](EDIT_SECTION* edit)
+	{
+		pack_layers_left(edit, false);
+	}
+	},
+	{ L"マーク間の隙間を詰める", [](EDIT_SECTION* edit)
+	{
+		pack_layers_left(edit, true);
+	}
+	},
+
 	// object duplication menu items.
 	{ L"オブジェクトを右へ複製", &duplicate_object_to_right },
 
@@ -2830,6 +5421,126 @@ obj_menu_items[] = {
 #undef NAME
 
 
+////////////////////////////////
+// command tracing.
+////////////////////////////////
+namespace command_trace
+{
+	// the file format is in command_trace.hpp.
+	constinit struct {
+		record records[256]{};
+		size_t count = 0;
+		HANDLE file = nullptr; // nullptr if not opened yet.
+		bool failed = false;
+	} state{};
+
+	// writes to the trace file, and stops tracing on failure.
+	static bool write(void const* data, size_t size)
+	{
+		DWORD written = 0;
+		if (::WriteFile(state.file, data, static_cast<DWORD>(size), &written, nullptr) != FALSE
+			&& written == size) return true;
+
+		::CloseHandle(state.file);
+		state.file = nullptr;
+		state.failed = true;
+		logging::warn(L"Failed to write to the trace file. Tracing is stopped.");
+		return false;
+	}
+
+	static bool open()
+	{
+		if (state.file != nullptr) return true;
+		if (state.failed) return false;
+
+		// a new trace file per session, keeping the previous one as ".trace.1".
+		auto const path = Settings::plugin_file_path(L".trace");
+		::MoveFileExW(path.c_str(), (path + L".1").c_str(), MOVEFILE_REPLACE_EXISTING);
+		HANDLE const h = ::CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (h == INVALID_HANDLE_VALUE) {
+			state.failed = true;
+			logging::warn(L"Failed to create the trace file.");
+			return false;
+		}
+		state.file = h;
+
+		// write the header and the names.
+		std::vector<wchar_t> names{};
+		for (auto const& item : edit_menu_items) names.insert(names.end(), item.name, item.name + std::wcslen(item.name) + 1);
+		for (auto const& item : obj_menu_items) names.insert(names.end(), item.name, item.name + std::wcslen(item.name) + 1);
+		LARGE_INTEGER freq; ::QueryPerformanceFrequency(&freq);
+		file_header const header{
+			.magic = magic, .version = version,
+			.counter_frequency = freq.QuadPart,
+			.edit_count = static_cast<uint32_t>(std::size(edit_menu_items)),
+			.obj_count = static_cast<uint32_t>(std::size(obj_menu_items)),
+			.names_size = static_cast<uint32_t>(names.size() * sizeof(wchar_t)),
+			.reserved = 0,
+		};
+		if (!write(&header, sizeof(header)) || !write(names.data(), header.names_size)) return false;
+
+		logging::verbose(L"Started tracing commands.");
+		return true;
+	}
+
+	static void flush()
+	{
+		if (state.count == 0) return;
+		if (open()) write(state.records, state.count * sizeof(record));
+		state.count = 0;
+	}
+
+	static void close()
+	{
+		flush();
+		if (state.file != nullptr) ::CloseHandle(state.file);
+		state.file = nullptr;
+	}
+
+	template<auto const& items, uint16_t index, size_t I>
+	static void invoke(EDIT_SECTION* edit)
+	{
+		if (!settings.trace.enabled) {
+			items[I].callback(edit);
+			return;
+		}
+
+		// the state before the command.
+		auto const& info = *edit->info;
+		record rec{
+			.command = index,
+			.selected_count = static_cast<uint16_t>(edit->get_selected_object_num()),
+			.scene_id = info.scene_id, .frame = info.frame, .layer = info.layer,
+			.frame_max = info.frame_max, .layer_max = info.layer_max,
+			.display_frame_start = info.display_frame_start, .display_layer_start = info.display_layer_start,
+		};
+
+		LARGE_INTEGER t0, t1;
+		::QueryPerformanceCounter(&t0);
+		items[I].callback(edit);
+		::QueryPerformanceCounter(&t1);
+		rec.start = t0.QuadPart;
+		rec.duration = static_cast<uint32_t>(std::min<int64_t>(t1.QuadPart - t0.QuadPart, std::numeric_limits<uint32_t>::max()));
+
+		// buffer the record, and write them out when full.
+		state.records[state.count++] = rec;
+		if (state.count >= std::size(state.records)) flush();
+	}
+
+	// callbacks wrapping each of the menu items.
+	template<auto const& items, uint16_t offset>
+	constexpr auto wrap_items()
+	{
+		return []<size_t... I>(std::index_sequence<I...>) {
+			return std::array<void(*)(EDIT_SECTION*), sizeof...(I)>{ &invoke<items, offset + I, I>... };
+		}(std::make_index_sequence<std::size(items)>{});
+	}
+	constexpr auto edit_callbacks = wrap_items<edit_menu_items, 0>();
+	constexpr auto obj_callbacks = wrap_items<obj_menu_items, std::size(edit_menu_items)>();
+}
+
+
 ////////////////////////////////
 // DLL main.
 ////////////////////////////////
@@ -2874,6 +5585,15 @@ extern "C" __declspec(dllexport) DWORD RequiredVersion()
 	return least_aviutl2_ver_num;
 }
 
+// cleanup before the plugin is unloaded.
+extern "C" __declspec(dllexport) void UninitializePlugin()
+{
+	// save the cursor history of the current project.
+	cursor_undo::save_history();
+	command_trace::close();
+	logging::flush();
+}
+
 // least version (in case of AviUtl2 before beta33).
 extern "C" __declspec(dllexport) bool InitializePlugin(DWORD version)
 {
@@ -2908,7 +5628,11 @@ extern "C" __declspec(dllexport) void RegisterPlugin(HOST_APP_TABLE* host)
 {
 	// load settings from .ini.
 	settings.load();
-	cursor_undo_queues = { static_cast<size_t>(settings.cursor_undo.queue_size) };
+	cursor_undo_queues = {
+		static_cast<size_t>(settings.cursor_undo.queue_size),
+		static_cast<size_t>(settings.cursor_undo.memory_budget) << 10,
+		settings.cursor_undo.polling_cooltime,
+	};
 
 	// 編集ハンドルを作成
 	edit_handle = host->create_edit_handle();
@@ -2916,15 +5640,22 @@ extern "C" __declspec(dllexport) void RegisterPlugin(HOST_APP_TABLE* host)
 	// create and register plugin window.
 	plugin_window.create_register_window(host, PLUGIN_NAME);
 
+	// forward the buffered log messages after the current command.
+	logging::buffer::request_flush = []
+	{
+		plugin_window.post_callback(PluginWindow::deferred::flush_log, +[](int) static { logging::flush(); }, 0);
+	};
+
 	// register menu items.
 	std::wstring const plugin_name = translate(PLUGIN_NAME, L"Menu");
-	for (auto const& item : edit_menu_items)
-		host->register_edit_menu(wstr_pool(plugin_name + L"\\" + translate(item.name)), item.callback);
-	for (auto const& item : obj_menu_items)
-		host->register_object_menu(translate(item.name), item.callback);
+	for (size_t i = 0; i < std::size(edit_menu_items); i++)
+		host->register_edit_menu(wstr_pool(plugin_name + L"\\" + translate(edit_menu_items[i].name)), command_trace::edit_callbacks[i]);
+	for (size_t i = 0; i < std::size(obj_menu_items); i++)
+		host->register_object_menu(translate(obj_menu_items[i].name), command_trace::obj_callbacks[i]);
 
 	// register event callbacks.
 	host->register_project_load_handler(&on_load_project);
+	host->register_project_save_handler(&on_save_project);
 	host->register_event_listener(EVENT_TYPE::CHANGE_EDIT_SCENE, nullptr, &on_scene_changed);
 	host->register_event_listener(EVENT_TYPE::CHANGE_EDIT_FRAME, nullptr, &on_frame_changed);
 	host->register_event_listener(EVENT_TYPE::UPDATE_OBJECT, nullptr, &on_update_object);